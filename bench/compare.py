@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compares two sane_bench --json reports and flags regressions.
+
+usage: compare.py baseline.json current.json [--threshold PERCENT]
+
+Exits with 1 when any benchmark got worse by more than the threshold
+(10% by default), so it can gate an upgrade or a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        report = json.load(file)
+    return report.get("context", {}), {result["name"]: result for result in report["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two sane_bench JSON reports.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percent a result may get worse before it counts as a regression")
+    args = parser.parse_args()
+
+    baseline_context, baseline = load(args.baseline)
+    current_context, current = load(args.current)
+
+    # Results from different machines or builds are not comparable. Filtered
+    # runs leave out the context of the groups they skipped.
+    for key in sorted(set(baseline_context) & set(current_context)):
+        before = baseline_context[key]
+        after = current_context[key]
+        if before != after:
+            print(f"warning: {key} differs: {before!r} -> {after!r}")
+
+    regressions = 0
+    print(f"{'benchmark':<44} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name, result in current.items():
+        if name not in baseline:
+            print(f"{name:<44} {'':>12} {result['value']:>12.2f} {'new':>9}")
+            continue
+
+        before = baseline[name]["value"]
+        after = result["value"]
+        change = (after - before) / before * 100.0 if before else 0.0
+        # Positive when it got worse, whichever direction is better
+        worse = change if result["lower_is_better"] else -change
+
+        status = ""
+        if worse > args.threshold:
+            status = "  REGRESSION"
+            regressions += 1
+        elif worse < -args.threshold:
+            status = "  improved"
+        print(f"{name:<44} {before:>12.2f} {after:>12.2f} {change:>+8.1f}%{status}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<44} {'':>12} {'':>12} {'missing':>9}")
+
+    if regressions:
+        print(f"\n{regressions} regression(s) above {args.threshold:g}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace sane::bench {
+    namespace {
+        std::string escapeJson(const std::string& inText) {
+            std::string escaped;
+            escaped.reserve(inText.size());
+            for (char c : inText) {
+                switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char code[8];
+                        std::snprintf(code, sizeof(code), "\\u%04x", c);
+                        escaped += code;
+                    }
+                    else {
+                        escaped += c;
+                    }
+                }
+            }
+            return escaped;
+        }
+    }
+
+    Suite::Suite(std::string inFilter) : mFilter(std::move(inFilter)) {}
+
+    bool Suite::isSelected(const std::string& inName) const {
+        return mFilter.empty() || inName.find(mFilter) != std::string::npos;
+    }
+
+    void Suite::add(Result inResult) {
+        std::printf("%-44s %14.2f %s\n", inResult.name.c_str(), inResult.value, inResult.unit.c_str());
+        std::fflush(stdout);
+        mResults.push_back(std::move(inResult));
+    }
+
+    void Suite::setContext(const std::string& inKey, std::string inValue) {
+        for (auto& [key, value] : mContext) {
+            if (key == inKey) {
+                value = std::move(inValue);
+                return;
+            }
+        }
+        mContext.emplace_back(inKey, std::move(inValue));
+    }
+
+    void Suite::writeJson(const std::string& inPath) const {
+        std::ofstream file(inPath);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + inPath);
+        }
+
+        file << "{\n  \"context\": {";
+        for (size_t i = 0; i < mContext.size(); ++i) {
+            file << (i ? ",\n" : "\n") << "    \"" << escapeJson(mContext[i].first) << "\": \""
+                << escapeJson(mContext[i].second) << "\"";
+        }
+        file << (mContext.empty() ? "},\n" : "\n  },\n");
+
+        file << "  \"results\": [";
+        char value[32];
+        for (size_t i = 0; i < mResults.size(); ++i) {
+            const auto& result = mResults[i];
+            std::snprintf(value, sizeof(value), "%.6g", result.value);
+            file << (i ? ",\n" : "\n") << "    { \"name\": \"" << escapeJson(result.name)
+                << "\", \"value\": " << value
+                << ", \"unit\": \"" << escapeJson(result.unit)
+                << "\", \"lower_is_better\": " << (result.lowerIsBetter ? "true" : "false") << " }";
+        }
+        file << (mResults.empty() ? "]\n}\n" : "\n  ]\n}\n");
+
+        if (!file) {
+            throw std::runtime_error("Failed to write " + inPath);
+        }
+    }
+
+    double Suite::median(std::vector<double> inValues) {
+        if (inValues.empty()) return 0.0;
+        auto middle = inValues.begin() + inValues.size() / 2;
+        std::nth_element(inValues.begin(), middle, inValues.end());
+        return *middle;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sane::bench {
+    using Clock = std::chrono::steady_clock;
+
+    // One measured value, written to the JSON report under its name
+    struct Result {
+        std::string name;
+        double value;
+        std::string unit;
+        bool lowerIsBetter;
+    };
+
+    // Keeps the compiler from dropping the computation of inValue
+    template<typename T>
+    inline void doNotOptimize(const T& inValue) {
+#if defined(_MSC_VER)
+        static volatile const void* sSink;
+        sSink = &inValue;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r"(&inValue) : "memory");
+#endif
+    }
+
+    // Collects the results of one run. Benchmarks check isSelected() and skip
+    // themselves when the --filter given on the command line leaves them out.
+    class Suite {
+    public:
+        // Batches are grown until one takes this long, the median batch is reported
+        static constexpr auto MIN_BATCH = std::chrono::milliseconds(20);
+        static constexpr uint32_t REPETITIONS = 7;
+
+        explicit Suite(std::string inFilter = "");
+
+        bool isSelected(const std::string& inName) const;
+
+        // Times inFn(), which performs inOperations operations per call, and
+        // adds the median time per operation in nanoseconds
+        template<typename Fn>
+        void timeOperation(const std::string& inName, Fn&& inFn, uint64_t inOperations = 1);
+
+        void add(Result inResult);
+        const std::vector<Result>& getResults() const { return mResults; }
+
+        // Written to the report next to the results, e.g. the GL renderer
+        void setContext(const std::string& inKey, std::string inValue);
+
+        // Throws when the file cannot be written
+        void writeJson(const std::string& inPath) const;
+
+    private:
+        static double median(std::vector<double> inValues);
+
+        std::string mFilter;
+        std::vector<Result> mResults;
+        std::vector<std::pair<std::string, std::string>> mContext;
+    };
+
+    template<typename Fn>
+    void Suite::timeOperation(const std::string& inName, Fn&& inFn, uint64_t inOperations) {
+        if (!isSelected(inName)) return;
+
+        auto runBatch = [&inFn](uint64_t inIterations) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < inIterations; ++i) {
+                inFn();
+            }
+            return Clock::now() - start;
+        };
+
+        // Doubles until a batch is long enough for the clock, which also warms caches up
+        uint64_t iterations = 1;
+        while (runBatch(iterations) < MIN_BATCH && iterations < (uint64_t{ 1 } << 40)) {
+            iterations *= 2;
+        }
+
+        std::vector<double> samples;
+        samples.reserve(REPETITIONS);
+        for (uint32_t i = 0; i < REPETITIONS; ++i) {
+            double nanoseconds = std::chrono::duration<double, std::nano>(runBatch(iterations)).count();
+            samples.push_back(nanoseconds / (double(iterations) * inOperations));
+        }
+        add({ inName, median(std::move(samples)), "ns/op", true });
+    }
+
+    // Benchmark groups. Buffer and shader benchmarks need a current GL context;
+    // scenes open their own headless application.
+    void runBufferBenchmarks(Suite& inSuite);
+    void runShaderBenchmarks(Suite& inSuite);
+    void runEcsBenchmarks(Suite& inSuite);
+    void runJobBenchmarks(Suite& inSuite);
+    void runEventBenchmarks(Suite& inSuite);
+    void runSceneBenchmarks(Suite& inSuite);
+}
@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "benchmark.hpp"
+#include "saneengine/gfx/buffers/buffer.hpp"
+#include "saneengine/gfx/buffers/streamingbuffer.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr uint32_t FRAMES = 500;
+        constexpr uint32_t UPLOAD_SIZES[] = { 64 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+
+        // The GPU reads every upload through a copy into this buffer, which is what
+        // makes the update() path wait on work still in flight
+        class Sink {
+        public:
+            explicit Sink(uint32_t inSize) {
+                glGenBuffers(1, &mBuffer);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+                glBufferData(GL_COPY_WRITE_BUFFER, inSize, nullptr, GL_STATIC_COPY);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            }
+
+            ~Sink() {
+                glDeleteBuffers(1, &mBuffer);
+            }
+
+            void consume(GLuint inSource, uint32_t inOffset, uint32_t inSize) const {
+                glBindBuffer(GL_COPY_READ_BUFFER, inSource);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, inOffset, 0, inSize);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            }
+
+        private:
+            GLuint mBuffer{ 0 };
+        };
+
+        double toMegabytesPerSecond(uint32_t inSize, Clock::duration inElapsed) {
+            double seconds = std::chrono::duration<double>(inElapsed).count();
+            return (double(inSize) * FRAMES) / (1024.0 * 1024.0) / seconds;
+        }
+
+        double benchUpdate(const std::vector<uint8_t>& inData, const Sink& inSink) {
+            auto size = static_cast<uint32_t>(inData.size());
+            gfx::Buffer buffer(GL_ARRAY_BUFFER, size, GL_STREAM_DRAW);
+
+            glFinish();
+            auto start = Clock::now();
+            for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+                buffer.update(size, 0, inData.data());
+                inSink.consume(buffer.getBufferId(), 0, size);
+            }
+            glFinish();
+            return toMegabytesPerSecond(size, Clock::now() - start);
+        }
+
+        double benchStreaming(const std::vector<uint8_t>& inData, const Sink& inSink, bool& outPersistent) {
+            auto size = static_cast<uint32_t>(inData.size());
+            gfx::StreamingBuffer buffer(GL_ARRAY_BUFFER, size);
+            outPersistent = buffer.isPersistent();
+
+            glFinish();
+            auto start = Clock::now();
+            for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+                uint32_t offset = buffer.write(inData.data(), size);
+                buffer.flush();
+                inSink.consume(buffer.getBufferId(), offset, size);
+                buffer.nextFrame();
+            }
+            glFinish();
+            return toMegabytesPerSecond(size, Clock::now() - start);
+        }
+    }
+
+    void runBufferBenchmarks(Suite& inSuite) {
+        for (auto size : UPLOAD_SIZES) {
+            std::string suffix = "/" + std::to_string(size / 1024) + "KiB";
+            bool update = inSuite.isSelected("buffer/update" + suffix);
+            bool streaming = inSuite.isSelected("buffer/streaming" + suffix);
+            if (!update && !streaming) continue;
+
+            std::vector<uint8_t> data(size);
+            for (uint32_t i = 0; i < size; ++i) {
+                data[i] = static_cast<uint8_t>(i * 31u);
+            }
+
+            Sink sink(size);
+            if (update) {
+                inSuite.add({ "buffer/update" + suffix, benchUpdate(data, sink), "MB/s", false });
+            }
+            if (streaming) {
+                bool persistent = false;
+                double megabytesPerSecond = benchStreaming(data, sink, persistent);
+                inSuite.setContext("streaming_buffer", persistent ? "persistent" : "unsynchronized");
+                inSuite.add({ "buffer/streaming" + suffix, megabytesPerSecond, "MB/s", false });
+            }
+        }
+    }
+}
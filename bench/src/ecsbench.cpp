@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glad/glad.h>
+
+#include "benchmark.hpp"
+#include "saneengine/ecs/components/transform.hpp"
+#include "saneengine/ecs/components/vertex.hpp"
+#include "saneengine/ecs/systems/hierarchysystem.hpp"
+#include "saneengine/ecs/transformpass.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr uint32_t ENTITY_COUNT = 10000;
+
+        std::vector<entt::entity> spawnTransforms(entt::registry& inRegistry) {
+            std::vector<entt::entity> entities(ENTITY_COUNT);
+            inRegistry.create(entities.begin(), entities.end());
+            for (uint32_t i = 0; i < ENTITY_COUNT; ++i) {
+                auto& transform = inRegistry.emplace<ecs::TransformComponent>(entities[i]);
+                transform.setPosition(float(i % 100), float(i / 100), 0.0f);
+                transform.setRotation(0.1f * i, 0.2f * i, 0.3f * i);
+                transform.setScale(1.0f, 2.0f, 1.0f);
+            }
+            return entities;
+        }
+    }
+
+    void runEcsBenchmarks(Suite& inSuite) {
+        const std::string count = std::to_string(ENTITY_COUNT);
+
+        if (inSuite.isSelected("ecs/transform_pass/" + count)) {
+            entt::registry registry;
+            auto entities = spawnTransforms(registry);
+            ecs::TransformPass pass;
+            inSuite.timeOperation("ecs/transform_pass/" + count, [&] {
+                pass.run(registry, entities.data(), entities.size());
+                doNotOptimize(pass.getModelMatrices());
+            }, ENTITY_COUNT);
+        }
+
+        // Every transform is dirtied, so each update recomputes all world matrices
+        if (inSuite.isSelected("ecs/hierarchy_update/" + count)) {
+            entt::registry registry;
+            spawnTransforms(registry);
+            ecs::HierarchySystem hierarchy;
+            hierarchy.onAttach(registry);
+            inSuite.timeOperation("ecs/hierarchy_update/" + count, [&] {
+                for (auto entity : registry.view<ecs::TransformComponent>()) {
+                    registry.patch<ecs::TransformComponent>(entity);
+                }
+                hierarchy.onUpdate(registry, 0.0f);
+            }, ENTITY_COUNT);
+            hierarchy.onDetach(registry);
+        }
+
+        // Nothing changed, an update should not visit the transforms at all
+        if (inSuite.isSelected("ecs/hierarchy_idle/" + count)) {
+            entt::registry registry;
+            spawnTransforms(registry);
+            ecs::HierarchySystem hierarchy;
+            hierarchy.onAttach(registry);
+            hierarchy.onUpdate(registry, 0.0f);
+            inSuite.timeOperation("ecs/hierarchy_idle/" + count, [&] {
+                hierarchy.onUpdate(registry, 0.0f);
+            });
+            hierarchy.onDetach(registry);
+        }
+
+        const float triangle[] = {
+            -0.5f, -0.2887f, 0.0f,
+             0.5f, -0.2887f, 0.0f,
+             0.0f,  0.5774f, 0.0f
+        };
+        ecs::VertexComponent prototype;
+        prototype.setVertexData(triangle, 3);
+        prototype.setAttributes({ { 0, 3, GL_FLOAT, false, 3 * sizeof(float), 0, 0 } });
+
+        inSuite.timeOperation("ecs/vertex_component/copy", [&] {
+            ecs::VertexComponent copy = prototype;
+            doNotOptimize(copy);
+        });
+
+        // Finds the mesh stored for this component by hash instead of storing another copy
+        ecs::VertexComponent stored;
+        stored.setVertexData(triangle, 3);
+        inSuite.timeOperation("ecs/vertex_component/set_vertex_data", [&] {
+            ecs::VertexComponent vertex;
+            vertex.setVertexData(triangle, 3);
+            doNotOptimize(vertex);
+        });
+    }
+}
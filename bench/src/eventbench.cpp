@@ -0,0 +1,69 @@
+#include <cstdint>
+
+#include "benchmark.hpp"
+#include "eventmanager.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr const char* TOPIC = "BenchTopic";
+        constexpr const char* EMIT = "events/emit_dispatch";
+        constexpr const char* EMIT_MEMBERS = "events/emit_members_dispatch";
+
+        struct BenchEvent {
+            int a{ 0 };
+            float b{ 0.0f };
+        };
+
+        class CountingSubscriber : public EventSubscriber<BenchEvent> {
+        public:
+            CountingSubscriber() : EventSubscriber<BenchEvent>(TOPIC) {}
+
+            void onEvent(const BenchEvent&) override {
+                ++mCount;
+            }
+
+            uint64_t getCount() const { return mCount; }
+
+        private:
+            uint64_t mCount{ 0 };
+        };
+
+        class CountingMemberSubscriber : public EventMemberSubscriber<BenchEvent> {
+        public:
+            CountingMemberSubscriber() : EventMemberSubscriber<BenchEvent>(TOPIC) {
+                subscribeToMember<BenchEvent, int>(&BenchEvent::a, [this](const int&) {
+                    ++mCount;
+                });
+            }
+
+            uint64_t getCount() const { return mCount; }
+
+        private:
+            uint64_t mCount{ 0 };
+        };
+    }
+
+    // The sandbox's EventManager, emitting and dispatching on the calling thread
+    void runEventBenchmarks(Suite& inSuite) {
+        if (!inSuite.isSelected(EMIT) && !inSuite.isSelected(EMIT_MEMBERS)) return;
+
+        EventManager<BenchEvent>::registerEventMembers(&BenchEvent::a, &BenchEvent::b);
+        EventManager<BenchEvent>::setInitialState(TOPIC, {});
+
+        CountingSubscriber subscriber;
+        CountingMemberSubscriber memberSubscriber;
+        BenchEvent event;
+
+        // Subscribers are notified on change only, so every emit changes the event
+        inSuite.timeOperation(EMIT, [&] {
+            ++event.a;
+            EventEmitter<BenchEvent>::emit(event, nullptr, TOPIC);
+        });
+        inSuite.timeOperation(EMIT_MEMBERS, [&] {
+            ++event.a;
+            EventEmitter<BenchEvent>::emitMembers(event, nullptr, TOPIC, &BenchEvent::a);
+        });
+
+        doNotOptimize(subscriber.getCount() + memberSubscriber.getCount());
+    }
+}
@@ -0,0 +1,35 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "benchmark.hpp"
+#include "saneengine/jobs/jobsystem.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr uint32_t JOB_COUNT = 1024;
+    }
+
+    void runJobBenchmarks(Suite& inSuite) {
+        jobs::JobSystem jobSystem;
+        // Without workers parallelFor runs inline
+        inSuite.setContext("job_workers", std::to_string(jobSystem.getWorkerCount()));
+        std::atomic<uint32_t> sum{ 0 };
+
+        // Enqueue, steal or pop and run, per job
+        inSuite.timeOperation("jobs/run_wait", [&] {
+            jobs::JobCounter counter;
+            for (uint32_t i = 0; i < JOB_COUNT; ++i) {
+                jobSystem.run([&sum] { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            jobSystem.wait(counter);
+        }, JOB_COUNT);
+
+        inSuite.timeOperation("jobs/parallel_for", [&] {
+            jobSystem.parallelFor(JOB_COUNT, 1, [&sum](size_t, size_t inCount) {
+                sum.fetch_add(static_cast<uint32_t>(inCount), std::memory_order_relaxed);
+            });
+        }, JOB_COUNT);
+        doNotOptimize(sum);
+    }
+}
@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+
+#include <glad/glad.h>
+
+#include "benchmark.hpp"
+#include "saneengine/math/simdtransform.hpp"
+#include "saneengine/window.hpp"
+
+namespace {
+    void printUsage() {
+        std::printf(
+            "usage: sane_bench [--json <path>] [--filter <substring>]\n"
+            "  --json    also write the results to <path>, see bench/compare.py\n"
+            "  --filter  only run benchmarks whose name contains <substring>\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string jsonPath;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json") && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else {
+            printUsage();
+            return !std::strcmp(argv[i], "--help") ? 0 : 1;
+        }
+    }
+
+    try {
+        sane::bench::Suite suite(filter);
+        suite.setContext("simd", sane::math::getSimdPath());
+#ifdef NDEBUG
+        suite.setContext("build", "release");
+#else
+        suite.setContext("build", "debug");
+#endif
+
+        {
+            // Hidden and uncapped, or an EGL context on machines without a display
+            sane::Window window("sane_bench", 64, 64, true);
+            window.initializeGlad();
+            // Loads the benchmark's own GL entry points, the engine's are loaded above
+            if (!gladLoadGLLoader(&sane::Window::getProcAddress)) {
+                std::fprintf(stderr, "Failed to initialize GLAD\n");
+                return 1;
+            }
+            const auto* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+            suite.setContext("renderer", renderer ? renderer : "unknown");
+            std::printf("%s\n", renderer ? renderer : "unknown");
+
+            sane::bench::runBufferBenchmarks(suite);
+            sane::bench::runShaderBenchmarks(suite);
+        }
+
+        sane::bench::runEcsBenchmarks(suite);
+        sane::bench::runJobBenchmarks(suite);
+        // Each scene opens its own headless application, which needs the window above gone
+        sane::bench::runSceneBenchmarks(suite);
+        sane::bench::runEventBenchmarks(suite);
+
+        if (!jsonPath.empty()) {
+            suite.writeJson(jsonPath);
+        }
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "benchmark.hpp"
+#include "saneengine/application.hpp"
+#include "saneengine/ecs/components/shader.hpp"
+#include "saneengine/ecs/components/transform.hpp"
+#include "saneengine/ecs/components/vertex.hpp"
+#include "saneengine/ecs/paralleleach.hpp"
+#include "saneengine/ecs/systemmanager.hpp"
+#include "saneengine/ecs/systems/hierarchysystem.hpp"
+#include "saneengine/ecs/systems/rendersystem.hpp"
+#include "saneengine/gfx/shaders/shaderprogram.hpp"
+#include "saneengine/layer/layer.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr uint32_t TRIANGLE_COUNTS[] = { 1000, 10000 };
+        constexpr uint32_t WARMUP_FRAMES = 60;
+        constexpr uint32_t MEASURED_FRAMES = 300;
+
+        constexpr const char* VERTEX_SOURCE = R"(
+            #version 330 core
+            layout (location = 0) in vec3 aPos;
+            layout (location = 4) in mat4 aModel;
+            layout (std140) uniform FrameData {
+                mat4 view;
+                mat4 projection;
+                mat4 viewProjection;
+                vec4 time;
+                vec4 viewport;
+            };
+
+            void main() {
+                gl_Position = viewProjection * aModel * vec4(aPos, 1.0);
+            }
+        )";
+
+        constexpr const char* FRAGMENT_SOURCE = R"(
+            #version 330 core
+            out vec4 FragColor;
+            void main() {
+                FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);
+            }
+        )";
+
+        // The sandbox scene: rotating triangles, here laid out on a grid filling
+        // the view. Records the time between rendered frames and closes the
+        // application once enough were measured.
+        class TriangleSceneLayer : public Layer {
+        public:
+            TriangleSceneLayer(Application& inApplication, uint32_t inCount)
+                : Layer("TriangleScene"), mApplication(inApplication), mCount(inCount)
+            {
+                mFrameTimes.reserve(MEASURED_FRAMES);
+            }
+
+            void onAttach() override {
+                mProgram = std::make_unique<gfx::ShaderProgram>(std::initializer_list<gfx::ShaderData>{
+                    { gfx::ShaderType::Vertex, VERTEX_SOURCE },
+                    { gfx::ShaderType::Fragment, FRAGMENT_SOURCE }
+                }, "TriangleShader");
+
+                ecs::VertexComponent vertex;
+                vertex.setVertexData({
+                    -0.5f, -0.2887f, 0.0f,
+                     0.5f, -0.2887f, 0.0f,
+                     0.0f,  0.5774f, 0.0f
+                    }, 3);
+                vertex.setAttributes({ { 0, 3, GL_FLOAT, false, 3 * sizeof(float), 0, 0 } });
+
+                ecs::ShaderComponent shader;
+                shader.programId = mProgram->getProgramId();
+                shader.initialized = true;
+
+                auto& systemManager = mApplication.getSystemManager();
+                auto entities = systemManager.spawn(mCount, vertex, shader, ecs::TransformComponent{});
+
+                auto side = static_cast<uint32_t>(std::ceil(std::sqrt(double(mCount))));
+                float spacing = 2.0f / side;
+                auto& registry = systemManager.getRegistry();
+                for (uint32_t i = 0; i < mCount; ++i) {
+                    auto& transform = registry.get<ecs::TransformComponent>(entities[i]);
+                    transform.setPosition(-1.0f + spacing * (i % side + 0.5f), -1.0f + spacing * (i / side + 0.5f), 0.0f);
+                    transform.setScale(spacing * 0.8f, spacing * 0.8f, 1.0f);
+                }
+            }
+
+            void onUpdate(float deltaTime) override {
+                auto& registry = mApplication.getSystemManager().getRegistry();
+                auto view = registry.view<ecs::TransformComponent>();
+                ecs::parallelEach(view, [](entt::entity, ecs::TransformComponent& transform) {
+                    transform.setRotation(transform.getRotationX(), transform.getRotationY(),
+                        transform.getRotationZ() + 0.01f);
+                });
+                // Change notifications are not thread safe, so they follow serially
+                for (auto entity : view) {
+                    registry.patch<ecs::TransformComponent>(entity);
+                }
+            }
+
+            void onRender() override {
+                auto now = Clock::now();
+                if (mRendered++ > WARMUP_FRAMES && mFrameTimes.size() < MEASURED_FRAMES) {
+                    mFrameTimes.push_back(std::chrono::duration<double, std::milli>(now - mLastFrame).count());
+                    if (mFrameTimes.size() == MEASURED_FRAMES) {
+                        mApplication.close();
+                    }
+                }
+                mLastFrame = now;
+            }
+
+            // Milliseconds between consecutive onRender calls, read once run() returned
+            const std::vector<double>& getFrameTimes() const { return mFrameTimes; }
+
+        private:
+            Application& mApplication;
+            uint32_t mCount;
+            std::unique_ptr<gfx::ShaderProgram> mProgram;
+
+            uint32_t mRendered{ 0 };
+            Clock::time_point mLastFrame;
+            std::vector<double> mFrameTimes;
+        };
+    }
+
+    void runSceneBenchmarks(Suite& inSuite) {
+        for (auto count : TRIANGLE_COUNTS) {
+            std::string prefix = "scene/triangles_" + std::to_string(count);
+            if (!inSuite.isSelected(prefix + "/frame_ms") && !inSuite.isSelected(prefix + "/frame_p99_ms")) continue;
+
+            Application application("sane_bench", 1280, 720, true);
+            auto layer = std::make_unique<TriangleSceneLayer>(application, count);
+            auto* scene = layer.get();
+            application.pushLayer(std::move(layer));
+            auto hierarchyId = application.startSystem(std::make_unique<ecs::HierarchySystem>());
+            auto renderId = application.startSystem(std::make_unique<ecs::RenderSystem>());
+
+            application.run();
+            application.stopSystem(renderId);
+            application.stopSystem(hierarchyId);
+
+            auto frameTimes = scene->getFrameTimes();
+            if (frameTimes.empty()) continue;
+
+            double total = 0.0;
+            for (double frameTime : frameTimes) {
+                total += frameTime;
+            }
+            auto p99 = frameTimes.begin() + (frameTimes.size() * 99) / 100;
+            std::nth_element(frameTimes.begin(), p99, frameTimes.end());
+
+            inSuite.add({ prefix + "/frame_ms", total / frameTimes.size(), "ms", true });
+            inSuite.add({ prefix + "/frame_p99_ms", *p99, "ms", true });
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include <glm/glm.hpp>
+
+#include "benchmark.hpp"
+#include "saneengine/gfx/shaders/shaderprogram.hpp"
+
+namespace sane::bench {
+    namespace {
+        constexpr const char* VERTEX_SOURCE = R"(
+            #version 330 core
+            layout (location = 0) in vec3 aPos;
+            uniform mat4 model;
+            void main() {
+                gl_Position = model * vec4(aPos, 1.0);
+            }
+        )";
+
+        constexpr const char* FRAGMENT_SOURCE = R"(
+            #version 330 core
+            uniform vec4 color;
+            out vec4 FragColor;
+            void main() {
+                FragColor = color;
+            }
+        )";
+    }
+
+    void runShaderBenchmarks(Suite& inSuite) {
+        gfx::ShaderProgram program({
+            { gfx::ShaderType::Vertex, VERTEX_SOURCE },
+            { gfx::ShaderType::Fragment, FRAGMENT_SOURCE }
+        }, "BenchShader");
+        program.bind();
+
+        auto modelHandle = program.getUniformHandle("model");
+        auto colorHandle = program.getUniformHandle("color");
+        glm::mat4 model{ 1.0f };
+        glm::vec4 color{ 1.0f };
+
+        // Values change every call so the handle setters cannot skip the GL call
+        inSuite.timeOperation("shader/set_uniform/name_mat4", [&] {
+            model[3][0] += 1.0f;
+            program.setUniform("model", model);
+        });
+        inSuite.timeOperation("shader/set_uniform/handle_mat4", [&] {
+            model[3][0] += 1.0f;
+            program.setUniform(modelHandle, model);
+        });
+        inSuite.timeOperation("shader/set_uniform/handle_mat4_unchanged", [&] {
+            program.setUniform(modelHandle, model);
+        });
+        inSuite.timeOperation("shader/set_uniform/name_vec4", [&] {
+            color.x += 1.0f;
+            program.setUniform("color", color);
+        });
+        inSuite.timeOperation("shader/set_uniform/handle_vec4", [&] {
+            color.x += 1.0f;
+            program.setUniform(colorHandle, color);
+        });
+
+        program.unbind();
+    }
+}
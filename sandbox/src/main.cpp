@@ -2,7 +2,9 @@
 
 #include <saneengine/entrypoint.hpp>
 #include <saneengine/ecs/systemmanager.hpp>
+#include <saneengine/ecs/paralleleach.hpp>
 #include <saneengine/layer/imguiperformancelayer.hpp>
+#include <saneengine/ecs/systems/hierarchysystem.hpp>
 #include <saneengine/ecs/systems/rendersystem.hpp>
 #include <saneengine/ecs/systemmanager.hpp>
 #include <saneengine/gfx/shaders/shaderprogram.hpp>
@@ -17,19 +19,22 @@ public:
     }
 
     void onAttach() override {
-        // Create triangle entity
-        auto& registry = mSystemManager.getRegistry();
-        auto entity = registry.create();
-
         static auto shaderProgram = std::make_unique<sane::gfx::ShaderProgram>(
             std::initializer_list<sane::gfx::ShaderData>{
                 {sane::gfx::ShaderType::Vertex, R"(
                 #version 330 core
                 layout (location = 0) in vec3 aPos;
-                uniform mat4 model;
+                layout (location = 4) in mat4 aModel;
+                layout (std140) uniform FrameData {
+                    mat4 view;
+                    mat4 projection;
+                    mat4 viewProjection;
+                    vec4 time;
+                    vec4 viewport;
+                };
 
                 void main() {
-                    gl_Position = model * vec4(aPos, 1.0);
+                    gl_Position = viewProjection * aModel * vec4(aPos, 1.0);
                 }
                 )"},
                 { sane::gfx::ShaderType::Fragment, R"(
@@ -43,8 +48,8 @@ public:
             "TriangleShader"
         );
 
-        // Add vertex component
-        auto& vertexComp = registry.emplace<sane::ecs::VertexComponent>(entity);
+        // Prototype components, copied into every spawned entity
+        sane::ecs::VertexComponent vertexComp;
         vertexComp.setVertexData({
             -0.5f, -0.2887f, 0.0f,
              0.5f, -0.2887f, 0.0f,
@@ -55,32 +60,37 @@ public:
         attributes.push_back({ 0, 3, GL_FLOAT, false, 3 * sizeof(float), 0, 0 }); // position attribute
         vertexComp.setAttributes(attributes);
 
-        // Add shader component
-        auto& shaderComp = registry.emplace<sane::ecs::ShaderComponent>(entity);
+        sane::ecs::ShaderComponent shaderComp;
         shaderComp.programId = shaderProgram->getProgramId();
         shaderComp.initialized = true;
 
-        // Add transform component
-        auto& transformComp = registry.emplace<sane::ecs::TransformComponent>(entity);
+        sane::ecs::TransformComponent transformComp;
         transformComp.setPosition(0.0f, 0.0f, 0.0f);
         transformComp.setRotation(0.0f, 0.0f, 0.0f);
         transformComp.setScale(1.0f, 1.0f, 1.0f);
+
+        // Create triangle entity
+        mSystemManager.spawn(1, vertexComp, shaderComp, transformComp);
     }
 
     void onUpdate(float deltaTime) override {
         auto& registry = mSystemManager.getRegistry();
-        auto view = registry.view<sane::ecs::ShaderComponent, sane::ecs::TransformComponent>();
-
-        for (auto entity : view) {
-            auto& transform = view.get<sane::ecs::TransformComponent>(entity);
-            auto& shader = view.get<sane::ecs::ShaderComponent>(entity);
+        auto view = registry.view<const sane::ecs::ShaderComponent, sane::ecs::TransformComponent>();
 
+        // Every entity only touches its own transform, so they rotate in parallel
+        sane::ecs::parallelEach(view, [](entt::entity entity, const sane::ecs::ShaderComponent& shader,
+            sane::ecs::TransformComponent& transform) {
             // Rotate
             transform.setRotation(
                 transform.getRotationX(),
                 transform.getRotationY(),
                 transform.getRotationZ() + 0.01f
             );
+        });
+
+        // Change notifications are not thread safe, so they follow serially
+        for (auto entity : view) {
+            registry.patch<sane::ecs::TransformComponent>(entity);
         }
     }
 
@@ -95,14 +105,17 @@ public:
         pushLayer(std::make_unique<sane::ImGuiPerformanceLayer>());
 
         // Add systems
+        mHierarchySystemId = startSystem(std::make_unique<sane::ecs::HierarchySystem>());
         mRenderSystemId = startSystem(std::make_unique<sane::ecs::RenderSystem>());
     }
 
     ~SandboxApplication() {
         stopSystem(mRenderSystemId);
+        stopSystem(mHierarchySystemId);
     }
 
 private:
+    sane::utils::UUID mHierarchySystemId;
     sane::utils::UUID mRenderSystemId;
 };
 
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "saneengine/gfx/commands/rendercommands.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <chrono>
+
+namespace sane::gfx {
+    class RenderCommandBuffer;
+
+    // Replays recorded command buffers into GL. Owns every GL resource the
+    // commands refer to, so it must live and die on the render thread.
+    class RenderCommandExecutor : utils::NotCopyable {
+    public:
+        RenderCommandExecutor();
+        ~RenderCommandExecutor();
+
+        // Applies resource commands and copies out the frame's draws, after
+        // which the buffer can be handed back. The previous snapshot is kept
+        // for interpolation.
+        void apply(const RenderCommandBuffer& commands);
+
+        // Draws the latest snapshot, blended from the previous one by alpha.
+        // Can be called any number of times per applied buffer.
+        SubmitStats draw(float alpha = 1.0f);
+
+        bool hasSnapshot() const;
+        std::chrono::steady_clock::time_point getSnapshotTime() const;
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "saneengine/utils/notcopyable.hpp"
+#include <cstdint>
+
+namespace sane::gfx {
+    // GPU time per render pass from GL timestamp queries. A frame's results
+    // are read FRAME_LATENCY frames later and only once all are available, so
+    // the CPU never waits for the GPU; frames still in flight are dropped.
+    // Durations go to utils::Timings as GpuPass tracks named after the pass.
+    // Lives on the render thread, every call needs the GL context current.
+    class GpuTimer : utils::NotCopyable {
+    public:
+        static constexpr uint32_t FRAME_LATENCY = 3;
+        static constexpr uint32_t MAX_PASSES = 32;
+
+        GpuTimer();
+        ~GpuTimer();
+
+        // Collects the oldest frame's results and starts recording a new frame
+        void beginFrame();
+
+        // Passes may nest. Ones past MAX_PASSES in a frame are not timed.
+        void beginPass(const char* name);
+        void endPass();
+
+        // False without timestamp query support or with timings compiled out
+        bool isSupported() const;
+
+        class Scope : utils::NotCopyable {
+        public:
+            Scope(GpuTimer& timer, const char* name) : mTimer(timer) { mTimer.beginPass(name); }
+            ~Scope() { mTimer.endPass(); }
+
+        private:
+            GpuTimer& mTimer;
+        };
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
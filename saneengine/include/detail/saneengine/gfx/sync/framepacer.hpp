@@ -0,0 +1,33 @@
+#pragma once
+
+#include "saneengine/utils/notcopyable.hpp"
+#include <cstdint>
+
+namespace sane::gfx {
+    // Paces the render thread after every swap. The limiter holds frames to a
+    // target frame time, sleeping until shortly before the deadline and
+    // spinning the rest, since sleeps overshoot by up to a scheduler tick.
+    // Low-latency mode fences each frame and waits for the GPU once more than
+    // maxQueuedFrames are in flight, so the CPU cannot queue ahead and input
+    // reaches the screen sooner.
+    // Lives on the render thread, every call needs the GL context current.
+    class FramePacer : utils::NotCopyable {
+    public:
+        static constexpr uint32_t MAX_QUEUED_FRAMES = 8;
+
+        FramePacer();
+        ~FramePacer();
+
+        // Seconds per frame, 0 turns the limiter off
+        void setTargetFrameTime(float seconds);
+        // 0 leaves queueing to the driver, larger values are clamped to MAX_QUEUED_FRAMES
+        void setMaxQueuedFrames(uint32_t frames);
+
+        // Call right after the swap
+        void endFrame();
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
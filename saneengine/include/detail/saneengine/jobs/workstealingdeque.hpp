@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace sane::jobs {
+    // Fixed capacity Chase-Lev deque (Le et al., "Correct and Efficient
+    // Work-Stealing for Weak Memory Models"). The owning thread pushes and pops
+    // at the bottom without locking, other threads steal from the top.
+    template<typename T, size_t Capacity>
+    class WorkStealingDeque {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Owner only. Returns false when full.
+        bool push(T* item) {
+            int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            int64_t top = mTop.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<int64_t>(Capacity)) {
+                return false;
+            }
+
+            mItems[bottom & MASK].store(item, std::memory_order_relaxed);
+            // Publishes the item, and what it points to, to thieves loading mBottom
+            mBottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only. Takes the most recently pushed item.
+        T* pop() {
+            int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = mItems[bottom & MASK].load(std::memory_order_relaxed);
+            if (top == bottom) {
+                // Last item, race the thieves for it
+                if (!mTop.compare_exchange_strong(top, top + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        // Any thread. Takes the oldest item, nullptr when empty or lost to another thread.
+        T* steal() {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = mBottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return nullptr;
+            }
+
+            T* item = mItems[top & MASK].load(std::memory_order_relaxed);
+            if (!mTop.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        bool isEmpty() const {
+            return mTop.load(std::memory_order_relaxed) >= mBottom.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr int64_t MASK = static_cast<int64_t>(Capacity) - 1;
+
+        // Thieves and the owner touch opposite ends, keep them on separate cache lines
+        alignas(64) std::atomic<int64_t> mTop{ 0 };
+        alignas(64) std::atomic<int64_t> mBottom{ 0 };
+        alignas(64) std::atomic<T*> mItems[Capacity]{};
+    };
+}
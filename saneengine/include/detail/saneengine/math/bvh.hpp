@@ -0,0 +1,63 @@
+#pragma once
+
+#include "saneengine/math/frustum.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sane::math {
+    // Dynamic AABB tree in the style of Box2D's b2DynamicTree. Leaves hold
+    // fattened boxes, so objects moving within their margin cost nothing, and
+    // the tree is rebalanced with rotations along each changed path.
+    class DynamicBvh {
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        int32_t insert(const Aabb& inBox, uint32_t inUserData);
+        void remove(int32_t inProxy);
+        // Returns false when inBox still fits the proxy's fat box
+        bool move(int32_t inProxy, const Aabb& inBox);
+        void clear();
+
+        int32_t getRoot() const;
+        size_t getLeafCount() const;
+
+        // Splits the tree into disjoint subtrees, at least inTargetCount unless
+        // the tree runs out of inner nodes, so queries can run in parallel
+        void collectSubtrees(size_t inTargetCount, std::vector<int32_t>& outRoots) const;
+
+        // Appends the user data of every leaf below inRoot touching the frustum.
+        // Subtrees fully inside are taken without testing their nodes.
+        void query(const Frustum& inFrustum, int32_t inRoot, std::vector<uint32_t>& outVisible) const;
+
+    private:
+        struct Node {
+            Aabb box;
+            // Next free node while on the free list
+            int32_t parent{ NULL_NODE };
+            int32_t child1{ NULL_NODE };
+            int32_t child2{ NULL_NODE };
+            // Leaves are 0, free nodes -1
+            int32_t height{ -1 };
+            uint32_t userData{ 0 };
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        int32_t allocateNode();
+        void freeNode(int32_t inNode);
+
+        void insertLeaf(int32_t inLeaf);
+        void removeLeaf(int32_t inLeaf);
+        // Rebalances and refits every ancestor from inNode up to the root
+        void refit(int32_t inNode);
+        int32_t balance(int32_t inNode);
+
+        void appendLeaves(int32_t inRoot, std::vector<uint32_t>& outVisible) const;
+
+        std::vector<Node> mNodes;
+        int32_t mRoot{ NULL_NODE };
+        int32_t mFreeList{ NULL_NODE };
+        size_t mLeafCount{ 0 };
+    };
+}
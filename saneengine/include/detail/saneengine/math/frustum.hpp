@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace sane::math {
+    struct Aabb {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    enum class Containment : uint8_t {
+        Outside,
+        Intersects,
+        Inside,
+    };
+
+    // World space box around a local box transformed by matrix
+    Aabb transformAabb(const Aabb& inBox, const glm::mat4& inMatrix);
+
+    // View frustum as six inward facing planes. Planes are kept
+    // structure-of-arrays and padded to eight so SSE tests four at a time.
+    class Frustum {
+    public:
+        // Contains everything until constructed from a camera
+        Frustum();
+        // Extracts the planes of an OpenGL style clip space (-w <= z <= w)
+        explicit Frustum(const glm::mat4& inViewProjection);
+
+        Containment test(const Aabb& inBox) const;
+
+    private:
+        static constexpr uint32_t PLANE_COUNT = 6;
+        static constexpr uint32_t PADDED_COUNT = 8;
+
+        alignas(16) float mX[PADDED_COUNT];
+        alignas(16) float mY[PADDED_COUNT];
+        alignas(16) float mZ[PADDED_COUNT];
+        alignas(16) float mW[PADDED_COUNT];
+    };
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace sane::math {
+    // Structure-of-arrays transform input. Every array holds at least `count`
+    // entries; angles are in radians.
+    struct TransformSoA {
+        const float* posX;
+        const float* posY;
+        const float* posZ;
+        const float* rotX;
+        const float* rotY;
+        const float* rotZ;
+        const float* scaleX;
+        const float* scaleY;
+        const float* scaleZ;
+    };
+
+    // Writes translate * rotateX * rotateY * rotateZ * scale as column-major
+    // 4x4 matrices (16 floats each) for entries [first, first + count).
+    // `outMatrices` points at the matrix of entry 0 and must be 16-byte aligned.
+    void composeModelMatrices(const TransformSoA& inTransforms, size_t first, size_t count, float* outMatrices);
+
+    // Name of the instruction set selected at compile time ("AVX2", "SSE2" or "Scalar")
+    const char* getSimdPath();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace sane::utils {
+    template<typename T, size_t Alignment>
+    class AlignedAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            ::operator delete(ptr, std::align_val_t(Alignment));
+        }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+        template<typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+    };
+} // namespace sane::utils
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace sane::utils {
+    struct SortItem {
+        uint64_t key;
+        uint32_t value;
+    };
+
+    // Stable LSD radix sort on the 64-bit keys, one byte per pass. Passes over
+    // bytes that every key shares are skipped, so sparse keys cost only the
+    // passes they use. ioScratch is resized as needed and can be reused.
+    void radixSort(std::vector<SortItem>& ioItems, std::vector<SortItem>& ioScratch);
+}
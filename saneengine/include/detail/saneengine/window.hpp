@@ -1,5 +1,7 @@
 #pragma once
+#include "saneengine/gfx/presentmode.hpp"
 #include "saneengine/utils/api.hpp"
+#include <atomic>
 #include <cstdint>
 
 struct GLFWwindow;
@@ -7,19 +9,48 @@ struct GLFWwindow;
 namespace sane {
     class SANEENGINE_API Window {
     public:
-        Window(const char* title = "Sane Engine", uint32_t width = 800, uint32_t height = 600);
+        // Headless windows render into an offscreen framebuffer and never
+        // present or wait for vsync. They use a hidden GLFW window, or an EGL
+        // surfaceless context where GLFW has no display to open one on.
+        Window(const char* title = "Sane Engine", uint32_t width = 800, uint32_t height = 600, bool headless = false);
         ~Window();
 
+        // Loads GL entry points and, when headless, creates the offscreen
+        // framebuffer. Needs the context current.
         void initializeGlad();
         bool shouldClose() const;
         void close();
         void swapBuffers();
+        void pollEvents();
+
+        // Applies to the context current on the calling thread, which must be
+        // this window's. Windows start with VSync. Returns the mode applied.
+        gfx::PresentMode setPresentMode(gfx::PresentMode mode);
+
+        // The context starts current on the constructing thread
+        void makeContextCurrent();
+        void releaseContext();
+
+        bool isHeadless() const;
+        // nullptr for an EGL context
         GLFWwindow* getNativeWindow() const;
 
+        // GL loader for the context current on the calling thread
+        static void* getProcAddress(const char* name);
+
     private:
+        void createEglContext();
+
         GLFWwindow* mGLFWwindow;
         const char* mTitle;
         uint32_t mWidth;
         uint32_t mHeight;
+        bool mHeadless;
+
+        // EGL display and context of a headless window without GLFW
+        void* mEglDisplay{ nullptr };
+        void* mEglContext{ nullptr };
+        uint32_t mFramebuffer{ 0 };
+        std::atomic<bool> mCloseRequested{ false };
     };
-}
\ No newline at end of file
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 // STL headers
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
 // Public headers
+#include "saneengine/gfx/presentmode.hpp"
 #include "saneengine/utils/api.hpp"
 #include "saneengine/utils/notcopyable.hpp"
 #include "saneengine/utils/api.hpp"
@@ -16,15 +18,46 @@ namespace sane {
         class System;
         class SystemManager;
     }
+    namespace jobs {
+        class JobSystem;
+    }
 
+    // Three threads share a frame: the main thread polls window events, the
+    // simulation thread runs layer updates and systems, recording render
+    // commands, and the render thread replays them and renders the layers.
     class SANEENGINE_API Application : public utils::NotCopyable {
     public:
+        // Headless applications render offscreen, uncapped and without
+        // presenting, for benchmarks and batch jobs. Setting the SANE_HEADLESS
+        // environment variable turns it on as well.
         Application(const char* name = "SaneApplication",
             uint32_t width = 1280,
-            uint32_t height = 720);
+            uint32_t height = 720,
+            bool headless = false);
         virtual ~Application();
 
         void run();
+        // Ends run() after the frames in flight, safe from any thread
+        void close();
+        bool isHeadless() const;
+
+        // Ticks layers and systems at a fixed rate instead of once per presented
+        // frame. The render thread interpolates transforms between the last two
+        // ticks. At most maxCatchUpTicks run back to back after a hitch, the
+        // rest of the backlog is dropped. Pass 0 to go back to variable rate.
+        void setFixedUpdateRate(float ticksPerSecond, uint32_t maxCatchUpTicks = 4);
+
+        // Frame pacing, each takes effect from the next rendered frame.
+        // VSync by default; headless applications never present.
+        void setPresentMode(gfx::PresentMode mode);
+        // Caps rendering at framesPerSecond with a sleep and spin limiter,
+        // 0 for no cap. Combines with vsync for a cap below the refresh rate.
+        void setFrameLimit(float framesPerSecond);
+        // Low-latency mode: the render thread waits for the GPU once more
+        // than frames are queued. 1 gives the lowest latency, 0 (the default)
+        // leaves queueing to the driver.
+        void setMaxQueuedFrames(uint32_t frames);
+
         void pushLayer(std::unique_ptr<Layer> layer);
         void popLayer();
 
@@ -34,9 +67,19 @@ namespace sane {
         ecs::System* getSystem(utils::UUID systemId);
         ecs::SystemManager& getSystemManager();
 
+        // Shared worker threads, also reachable as jobs::JobSystem::get()
+        jobs::JobSystem& getJobSystem();
+
+        // Peak utils::FrameArena usage in bytes of the last simulation tick
+        // and of the last rendered frame
+        size_t getSimulationArenaPeak() const;
+        size_t getRenderArenaPeak() const;
+
     private:
         void mainLoop();
         void setupRenderThread();
+        void setupSimulationThread();
+        void simulateFrame(float deltaTime);
 
         class Impl;
         Impl* mImpl;
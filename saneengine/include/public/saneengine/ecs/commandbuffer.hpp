@@ -0,0 +1,132 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sane::ecs {
+    // Records structural changes to a registry for later: creates, destroys,
+    // emplaces and removes. A buffer is written by one thread at a time; every
+    // system has its own, played back by SystemManager once all systems are done.
+    class SANEENGINE_API CommandBuffer : public utils::NotCopyable {
+    public:
+        // Entity the buffer creates on playback, only valid in the buffer that returned it
+        struct Created {
+            uint32_t index;
+        };
+
+        // Entity a command applies to: an existing one or one created by the same buffer
+        struct Target {
+            Target(entt::entity entity) : entity(entity) {}
+            Target(Created created) : created(created.index + 1) {}
+
+            entt::entity entity{ entt::null };
+            uint32_t created{ 0 };
+        };
+
+        CommandBuffer();
+        ~CommandBuffer();
+
+        Created create();
+        void destroy(Target target);
+
+        // Emplaces the component, or replaces it when the entity already has one
+        template<typename Component, typename... Args>
+        void emplace(Target target, Args&&... args);
+
+        template<typename Component>
+        void remove(Target target);
+
+        bool empty() const;
+        void clear();
+
+        // Plays the buffers back in order and clears them. Entities are created
+        // first, then component commands run one type at a time, each type in
+        // recorded order, then entities are destroyed. Commands on entities that
+        // are no longer valid are dropped.
+        static void playback(entt::registry& registry, std::span<CommandBuffer* const> buffers);
+        void playback(entt::registry& registry);
+
+    private:
+        class Queue {
+        public:
+            virtual ~Queue() = default;
+
+            virtual size_t getEmplaceCount() const = 0;
+            virtual void reserve(entt::registry& registry, size_t count) = 0;
+            virtual void play(entt::registry& registry, const std::vector<entt::entity>& created) = 0;
+            virtual void clear() = 0;
+        };
+
+        template<typename Component>
+        class ComponentQueue final : public Queue {
+        public:
+            size_t getEmplaceCount() const override {
+                return values.size();
+            }
+
+            void reserve(entt::registry& registry, size_t count) override {
+                auto& storage = registry.storage<Component>();
+                storage.reserve(storage.size() + count);
+            }
+
+            void play(entt::registry& registry, const std::vector<entt::entity>& created) override {
+                size_t value = 0;
+                for (const auto& command : commands) {
+                    auto entity = command.target.created ? created[command.target.created - 1] : command.target.entity;
+                    bool valid = registry.valid(entity);
+                    if (command.remove) {
+                        if (valid) registry.remove<Component>(entity);
+                        continue;
+                    }
+                    if (valid) registry.emplace_or_replace<Component>(entity, std::move(values[value]));
+                    ++value;
+                }
+            }
+
+            void clear() override {
+                commands.clear();
+                values.clear();
+            }
+
+            struct Command {
+                Target target;
+                bool remove;
+            };
+
+            std::vector<Command> commands;
+            // One per emplace command, in the same order
+            std::vector<Component> values;
+        };
+
+        template<typename Component>
+        static std::unique_ptr<Queue> createQueue() {
+            return std::make_unique<ComponentQueue<Component>>();
+        }
+
+        Queue& getQueue(entt::id_type type, std::unique_ptr<Queue>(*create)());
+
+        class Impl;
+        Impl* mImpl;
+    };
+
+    template<typename Component, typename... Args>
+    void CommandBuffer::emplace(Target target, Args&&... args) {
+        auto& queue = static_cast<ComponentQueue<Component>&>(
+            getQueue(entt::type_hash<Component>::value(), &createQueue<Component>));
+        queue.values.emplace_back(std::forward<Args>(args)...);
+        queue.commands.push_back({ target, false });
+    }
+
+    template<typename Component>
+    void CommandBuffer::remove(Target target) {
+        auto& queue = static_cast<ComponentQueue<Component>&>(
+            getQueue(entt::type_hash<Component>::value(), &createQueue<Component>));
+        queue.commands.push_back({ target, true });
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "saneengine/utils/api.hpp"
+#include <glm/glm.hpp>
+
+namespace sane::ecs {
+    class VertexComponent;
+
+    // Local space box around an entity's geometry. RenderSystem derives it
+    // from the VertexComponent whenever that changes and culls against it.
+    struct SANEENGINE_API BoundsComponent {
+        glm::vec3 min{ 0.0f };
+        glm::vec3 max{ 0.0f };
+
+        static BoundsComponent fromVertices(const VertexComponent& vertex);
+    };
+}
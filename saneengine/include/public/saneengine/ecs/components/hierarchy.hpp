@@ -0,0 +1,17 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include <cstdint>
+#include <entt/entt.hpp>
+
+namespace sane::ecs {
+    // Intrusive parent/child links. Use HierarchySystem::setParent() to edit
+    // them so depths and sibling lists stay consistent.
+    struct SANEENGINE_API HierarchyComponent {
+        entt::entity parent{ entt::null };
+        entt::entity firstChild{ entt::null };
+        entt::entity nextSibling{ entt::null };
+        entt::entity prevSibling{ entt::null };
+        uint32_t depth{ 0 };
+    };
+}
@@ -7,5 +7,9 @@ namespace sane::ecs {
     struct SANEENGINE_API ShaderComponent {
         uint32_t programId{ 0 };
         bool initialized{ false };
+        // Draw order: lower layers first, then opaque front to back, then
+        // transparent back to front. Only the low 4 bits of the layer are used.
+        uint8_t renderLayer{ 0 };
+        bool transparent{ false };
     };
 }
\ No newline at end of file
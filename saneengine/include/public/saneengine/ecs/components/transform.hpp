@@ -1,7 +1,13 @@
 #pragma once
 #include "saneengine/utils/api.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <vector>
 
 namespace sane::ecs {
+    // Change transforms of entities through registry.patch or replace, which
+    // tell HierarchySystem. Setters called on a reference from get() or a
+    // view go unnoticed until the entity is patched.
     class SANEENGINE_API TransformComponent {
     public:
         // Position
@@ -28,6 +34,17 @@ namespace sane::ecs {
             scaleX = x; scaleY = y; scaleZ = z;
         }
 
+        // Cached world matrix, kept current by the HierarchySystem
+        const glm::mat4& getWorldMatrix() const { return worldMatrix; }
+        void setWorldMatrix(const glm::mat4& matrix) {
+            worldMatrix = matrix;
+            dirty = false;
+        }
+
+        // Set while HierarchySystem has the transform queued within an update
+        bool isDirty() const { return dirty; }
+        void markDirty() { dirty = true; }
+
     private:
         // Position
         float posX{ 0.0f };
@@ -43,5 +60,14 @@ namespace sane::ecs {
         float scaleX{ 1.0f };
         float scaleY{ 1.0f };
         float scaleZ{ 1.0f };
+
+        glm::mat4 worldMatrix{ 1.0f };
+        bool dirty{ false };
+    };
+
+    // Entities whose world matrix HierarchySystem recomputed during the current
+    // update. Lives in the registry context for systems that run after it.
+    struct SANEENGINE_API WorldMatrixUpdates {
+        std::vector<entt::entity> entities;
     };
 }
\ No newline at end of file
@@ -1,39 +1,37 @@
 #pragma once
 #include "saneengine/utils/api.hpp"
 #include "saneengine/gfx/buffers/vertexattribute.hpp"
+#include "saneengine/gfx/meshes/meshregistry.hpp"
 #include <cstdint>
 #include <initializer_list>
 #include <vector>
 
 namespace sane::ecs {
+    // Geometry lives in the gfx::MeshRegistry; the component holds a handle to
+    // it, so copies are a reference count and identical meshes are stored once.
     class SANEENGINE_API VertexComponent {
     public:
-        VertexComponent();
-        ~VertexComponent();
-        VertexComponent(const VertexComponent& other);
-        VertexComponent& operator=(const VertexComponent& other);
+        VertexComponent() = default;
+        explicit VertexComponent(gfx::MeshHandle mesh);
 
+        // Edit live components through registry.patch<VertexComponent>() so
+        // the RenderSystem re-uploads the mesh
         void setVertexData(const float* data, size_t count);
         void setVertexData(std::initializer_list<float> data, size_t count);
+        void setMesh(gfx::MeshHandle mesh);
 
+        const gfx::MeshHandle& getMesh() const { return mesh; }
         const float* getVertices() const;
         size_t getVertexCount() const;
 
         bool isInitialized() const;
         void setInitialized(bool value);
 
-        void setAttributes(const std::vector<gfx::VertexAttribute>& attrs) {
-            attributes = attrs;
-        }
-
-        const std::vector<gfx::VertexAttribute>& getAttributes() const {
-            return attributes;
-        }
+        void setAttributes(const std::vector<gfx::VertexAttribute>& attrs);
+        const std::vector<gfx::VertexAttribute>& getAttributes() const;
 
     private:
-        float* vertices{ nullptr };
-        size_t vertexCount{ 0 };
+        gfx::MeshHandle mesh;
         bool initialized{ false };
-        std::vector<gfx::VertexAttribute> attributes;
     };
-}
\ No newline at end of file
+}
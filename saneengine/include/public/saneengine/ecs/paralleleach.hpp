@@ -0,0 +1,53 @@
+#pragma once
+
+#include "saneengine/jobs/jobsystem.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <entt/entt.hpp>
+#include <tuple>
+
+namespace sane::ecs {
+    // Calls fn(entity, components...) like view.each(), with the view's leading
+    // storage split into chunks that run as jobs. The grain grows with the
+    // entity count so every thread gets a few pieces to steal, but pieces never
+    // drop below minGrain entities. Runs inline without a JobSystem or when the
+    // view is too small to split.
+    //
+    // fn runs concurrently: it may write the components it is handed, but must
+    // not add or remove components or entities. Use jobs::PerThread for results.
+    template<typename View, typename Fn>
+    void parallelEach(const View& view, Fn&& fn, size_t minGrain = 1024) {
+        // Pieces are whole chunks of the packed arrays, so neighbours rarely share a cache line
+        constexpr size_t CHUNK_SIZE = 64;
+        constexpr size_t PIECES_PER_THREAD = 4;
+
+        const auto* handle = view.handle();
+        if (!handle || handle->empty()) return;
+
+        const auto* entities = handle->data();
+        size_t size = handle->size();
+        auto process = [&](size_t first, size_t count) {
+            for (size_t i = first; i < first + count; ++i) {
+                auto entity = entities[i];
+                // The leading storage may hold entities missing the other components
+                if (!view.contains(entity)) continue;
+                std::apply([&](auto&&... components) { fn(entity, components...); }, view.get(entity));
+            }
+        };
+
+        auto* jobSystem = jobs::JobSystem::get();
+        size_t threads = jobSystem ? jobSystem->getWorkerCount() + 1 : 1;
+        size_t chunkCount = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        size_t grain = std::max((std::max<size_t>(minGrain, 1) + CHUNK_SIZE - 1) / CHUNK_SIZE,
+            chunkCount / (threads * PIECES_PER_THREAD));
+        if (threads == 1 || chunkCount <= grain) {
+            process(0, size);
+            return;
+        }
+
+        jobSystem->parallelFor(chunkCount, grain, [&](size_t firstChunk, size_t chunks) {
+            size_t first = firstChunk * CHUNK_SIZE;
+            process(first, std::min(chunks * CHUNK_SIZE, size - first));
+        });
+    }
+}
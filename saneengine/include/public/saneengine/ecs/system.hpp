@@ -1,11 +1,16 @@
 #pragma once
 
+#include "saneengine/ecs/commandbuffer.hpp"
 #include "saneengine/utils/api.hpp"
 #include "saneengine/utils/notcopyable.hpp"
+#include "saneengine/utils/timings.hpp"
 #include "saneengine/utils/uuid.hpp"
+#include <cstdint>
 #include <entt/entt.hpp>
 
 namespace sane::ecs {
+    // Systems declare the components and registry context values they read and
+    // write so SystemManager can update systems that do not conflict at the same time.
     class SANEENGINE_API System : public utils::NotCopyable {
     public:
         explicit System(const char* name = "System", int32_t priority = 0);
@@ -25,7 +30,58 @@ namespace sane::ecs {
         utils::UUID getId() const;
         void setId(utils::UUID id);
 
+        // True when the two must not update at the same time: one writes a
+        // component or context value the other touches, or either one is exclusive
+        bool conflictsWith(const System& other) const;
+        bool isExclusive() const;
+
+        // Structural changes made during onUpdate. Played back by SystemManager
+        // in priority order once every system has updated.
+        CommandBuffer& getCommands();
+
+        // onUpdate durations, recorded by SystemManager. nullptr when timings are compiled out.
+        utils::TimingTrack* getTiming() const;
+
+        // Creates the storage of every declared component up front, so views
+        // never add one to the registry while other systems are running
+        void prepareStorage(entt::registry& registry) const;
+
+    protected:
+        // Call from the constructor. A system declaring nothing is exclusive and
+        // updates alone. Entities and components a system creates or destroys
+        // go through getCommands(), so that needs no declaration.
+        template<typename... Components>
+        void declareReads() {
+            (addAccess(entt::type_hash<Components>::value(), false, &createStorage<Components>), ...);
+        }
+
+        template<typename... Components>
+        void declareWrites() {
+            (addAccess(entt::type_hash<Components>::value(), true, &createStorage<Components>), ...);
+        }
+
+        // Values kept in registry.ctx() rather than in component storages
+        template<typename... Resources>
+        void declareResourceReads() {
+            (addAccess(entt::type_hash<Resources>::value(), false, nullptr), ...);
+        }
+
+        template<typename... Resources>
+        void declareResourceWrites() {
+            (addAccess(entt::type_hash<Resources>::value(), true, nullptr), ...);
+        }
+
+        void declareExclusive();
+
     private:
+        template<typename Component>
+        static void createStorage(entt::registry& registry) {
+            registry.storage<Component>();
+        }
+
+        // create is nullptr for context values
+        void addAccess(entt::id_type type, bool write, void (*create)(entt::registry&));
+
         class Impl;
         Impl* mImpl;
     };
@@ -5,10 +5,15 @@
 #include "saneengine/utils/uuid.hpp"
 #include <entt/entt.hpp>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace sane::ecs {
     class System;
 
+    // Updates systems in priority order. Systems whose declared component
+    // access does not conflict run at the same time as jobs; the
+    // dependency graph is rebuilt whenever a system is added or removed.
     class SANEENGINE_API SystemManager : public utils::NotCopyable {
     public:
         SystemManager();
@@ -24,8 +29,39 @@ namespace sane::ecs {
         void update(float deltaTime);
         entt::registry& getRegistry();
 
+        // Creates count entities that each get a copy of every prototype
+        // component. Storage is reserved up front and the entities and each
+        // component are created as one range.
+        template<typename... Component>
+        std::vector<entt::entity> spawn(size_t count, const Component&... prototype);
+
+        // Destroys a range of entities, removing them pool by pool
+        template<typename It>
+        void destroy(It first, It last);
+
     private:
         class Impl;
         Impl* mImpl;
     };
+
+    template<typename... Component>
+    std::vector<entt::entity> SystemManager::spawn(size_t count, const Component&... prototype) {
+        auto& registry = getRegistry();
+        std::vector<entt::entity> entities(count);
+        registry.create(entities.begin(), entities.end());
+
+        auto insert = [&](const auto& component) {
+            using Type = std::decay_t<decltype(component)>;
+            auto& storage = registry.storage<Type>();
+            storage.reserve(storage.size() + count);
+            registry.insert<Type>(entities.begin(), entities.end(), component);
+        };
+        (insert(prototype), ...);
+        return entities;
+    }
+
+    template<typename It>
+    void SystemManager::destroy(It first, It last) {
+        getRegistry().destroy(first, last);
+    }
 }
\ No newline at end of file
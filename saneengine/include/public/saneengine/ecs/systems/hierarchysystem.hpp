@@ -0,0 +1,33 @@
+#pragma once
+#include "saneengine/ecs/system.hpp"
+#include "saneengine/utils/api.hpp"
+#include <cstdint>
+
+namespace sane::ecs {
+    // Keeps TransformComponent world matrices current. Only transforms changed
+    // through the registry (emplace, patch or replace) and their descendants
+    // are recomputed, parents before children. Nothing else is visited.
+    // The entities it touched each update are listed in the WorldMatrixUpdates
+    // registry context entry.
+    class SANEENGINE_API HierarchySystem : public System {
+    public:
+        // Runs ahead of systems with the default priority, such as RenderSystem
+        static constexpr int32_t DEFAULT_PRIORITY = -100;
+
+        HierarchySystem();
+        ~HierarchySystem() override;
+
+        void onAttach(entt::registry& registry) override;
+        void onDetach(entt::registry& registry) override;
+        void onUpdate(entt::registry& registry, float deltaTime) override;
+
+        // Passing entt::null as parent turns child into a root
+        static void setParent(entt::registry& registry, entt::entity child, entt::entity parent);
+
+        uint32_t getUpdatedCount() const;
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
@@ -1,10 +1,42 @@
 #pragma once
 #include "saneengine/ecs/system.hpp"
 #include "saneengine/utils/api.hpp"
+#include <cstdint>
+#include <glm/glm.hpp>
 
 namespace sane::ecs {
+    struct SANEENGINE_API RenderStats {
+        uint32_t entities{ 0 };
+        // Entities with bounds rejected by frustum culling
+        uint32_t culled{ 0 };
+        uint32_t batches{ 0 };
+        // Reported by the render thread, so one frame behind the counts above
+        uint32_t drawCalls{ 0 };
+        // Draw calls saved by instancing (entities - drawCalls)
+        uint32_t mergedDraws{ 0 };
+        // GL state changes after redundant binds were skipped, also one frame behind
+        uint32_t programBinds{ 0 };
+        uint32_t vertexArrayBinds{ 0 };
+        uint32_t bufferBinds{ 0 };
+    };
+
+    // Draws entities with Shader, Vertex and Transform components using the
+    // cached world matrices maintained by HierarchySystem, which must be
+    // started as well; updating without it throws. Camera, time and
+    // viewport reach every program through the FrameData uniform block.
+    // Runs on the simulation thread and never touches GL: it records batches
+    // into the gfx::RenderCommandQueue found in the registry context, which the
+    // render thread replays. Batches are radix sorted on a 64-bit key (layer,
+    // opacity, program, mesh, depth) so consecutive draws share state.
+    // Entities are culled against the camera frustum through a dynamic BVH
+    // over their BoundsComponent, so only visible ones are batched.
     class SANEENGINE_API RenderSystem : public System {
     public:
+        // Programs declaring this mat4 attribute are drawn instanced; all others
+        // fall back to one draw per entity, reading the ObjectData uniform block
+        // when declared and a "model" uniform otherwise.
+        static constexpr const char* INSTANCE_MODEL_ATTRIBUTE = "aModel";
+
         RenderSystem();
         ~RenderSystem() override;
 
@@ -12,7 +44,18 @@ namespace sane::ecs {
         void onDetach(entt::registry& registry) override;
         void onUpdate(entt::registry& registry, float deltaTime) override;
 
+        // Safe from any thread, takes effect at the next update
+        void setCamera(const glm::mat4& view, const glm::mat4& projection);
+
+        // On by default. Disabled, every entity is drawn whether on screen or not.
+        void setCullingEnabled(bool enabled);
+        bool isCullingEnabled() const;
+
+        // Copy of the last completed update, safe from any thread
+        RenderStats getStats() const;
+
     private:
-        uint32_t mVao{ 0 }, mVbo{ 0 };
+        class Impl;
+        Impl* mImpl;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+namespace sane::ecs {
+    // Computes the local model matrices of a set of TransformComponents into one
+    // contiguous, cache line aligned array. The work is vectorized (AVX2/SSE2 with a scalar
+    // fallback) and split into jobs on the engine's JobSystem when one exists.
+    class SANEENGINE_API TransformPass : public utils::NotCopyable {
+    public:
+        TransformPass();
+        ~TransformPass();
+
+        // Every entity must own a TransformComponent
+        void run(entt::registry& registry, const entt::entity* entities, size_t count);
+
+        // Matrices are ordered like the entities passed to run() and stay valid
+        // until the next run()
+        const glm::mat4* getModelMatrices() const;
+        size_t size() const;
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
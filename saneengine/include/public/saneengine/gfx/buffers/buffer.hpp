@@ -23,7 +23,13 @@ namespace sane::gfx
 
         virtual void clone(Buffer& inBuffer);
 
+        GLuint getBufferId() const;
+        uint32_t getSize() const;
+
     protected:
+        // Creates the buffer name only, derived classes allocate storage themselves
+        explicit Buffer(GLuint inTarget);
+
         GLuint mTargetType;
         GLuint mBuffer;
         uint32_t mSize;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "saneengine/gfx/buffers/buffer.hpp"
+
+namespace sane::gfx
+{
+    // Ring buffer with one region per frame in flight that the CPU writes
+    // through a mapping, never through glBufferSubData. Uses persistent
+    // coherent storage when GL_ARB_buffer_storage is available and
+    // unsynchronized glMapBufferRange otherwise. Each region is guarded by a
+    // fence so it is only reused once the GPU has finished reading it.
+    class StreamingBuffer : public Buffer
+    {
+    public:
+        static constexpr uint32_t FRAME_COUNT = 3;
+
+        StreamingBuffer(GLuint inTarget, uint32_t inFrameSize);
+        virtual ~StreamingBuffer();
+
+        // Reserves space in the current frame region. Returns nullptr when the
+        // region is full. The pointer stays valid until flush() or nextFrame().
+        void* allocate(uint32_t inSize, uint32_t& outOffset, uint32_t inAlignment = 16);
+
+        // Copies data into the current frame region and returns its buffer offset
+        uint32_t write(const void* inData, uint32_t inSize, uint32_t inAlignment = 16);
+
+        // Makes writes visible to the GPU; call before drawing from this frame's data
+        void flush();
+
+        // Fences the current region and moves to the next one, waiting only if
+        // the GPU is still reading it
+        void nextFrame();
+
+        void bindRange(uint32_t inBinding, uint32_t inOffset, uint32_t inSize) const;
+
+        bool isPersistent() const;
+        uint32_t getFrameSize() const;
+        // Bytes written to the current frame region so far
+        uint32_t getFrameUsage() const;
+
+    private:
+        // The storage is immutable or mapped, so glBufferSubData and copies would
+        // fail. Data only goes in through allocate() and write(); these throw.
+        void update(uint32_t inSize, uint32_t inOffset, const void* inData) override;
+        void move(uint32_t inSize, uint32_t inSrcOffset, uint32_t inDstOffset) override;
+        void clone(Buffer& inBuffer) override;
+
+        void mapCurrentRegion();
+
+        uint32_t mFrameSize;
+        uint32_t mFrameIndex{ 0 };
+        uint32_t mHead{ 0 };
+        uint32_t mFlushedHead{ 0 };
+        bool mPersistent{ false };
+        uint8_t* mMapping{ nullptr };
+        // Start of the mapped range relative to the current region (unsynchronized path)
+        uint32_t mMappedFrom{ 0 };
+        GLsync mFences[FRAME_COUNT]{};
+    };
+} // namespace sane::gfx
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <saneengine/utils/api.hpp>
+
+namespace sane::gfx
+{
+    class ShaderReflection;
+
+    // std140 block shared by every program, declared in GLSL as
+    //   layout (std140) uniform FrameData {
+    //       mat4 view; mat4 projection; mat4 viewProjection; vec4 time; vec4 viewport;
+    //   };
+    struct FrameUniforms
+    {
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::mat4 viewProjection{ 1.0f };
+        // x: seconds since start, y: delta time, z: frame index
+        glm::vec4 time{ 0.0f };
+        // x, y, width, height in pixels
+        glm::vec4 viewport{ 0.0f };
+    };
+
+    // std140 per-draw block: layout (std140) uniform ObjectData { mat4 model; };
+    struct ObjectUniforms
+    {
+        glm::mat4 model{ 1.0f };
+    };
+
+    constexpr const char* FRAME_UNIFORM_BLOCK = "FrameData";
+    constexpr uint32_t FRAME_UNIFORM_BINDING = 0;
+
+    constexpr const char* OBJECT_UNIFORM_BLOCK = "ObjectData";
+    constexpr uint32_t OBJECT_UNIFORM_BINDING = 1;
+
+    // Points the engine blocks a program declares at their fixed binding points
+    SANEENGINE_API void bindEngineUniformBlocks(const ShaderReflection& inReflection);
+} // namespace sane::gfx
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include "saneengine/gfx/buffers/buffer.hpp"
+
+namespace sane::gfx
+{
+    class UniformBuffer : public Buffer
+    {
+    public:
+        UniformBuffer(uint32_t inSize, GLenum inUsage = GL_DYNAMIC_DRAW, const void* inData = nullptr);
+        virtual ~UniformBuffer() = default;
+
+        void bindBase(uint32_t inBinding) const;
+        void bindRange(uint32_t inBinding, uint32_t inOffset, uint32_t inSize) const;
+
+        // Required alignment of bindRange offsets (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+        static uint32_t getOffsetAlignment();
+    };
+} // namespace sane::gfx
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <saneengine/gfx/commands/rendercommands.hpp>
+#include <saneengine/utils/notcopyable.hpp>
+
+namespace sane::gfx
+{
+    // Linear, per-frame storage for render commands. Commands are POD structs
+    // with a TYPE tag, packed back to back behind a small header. Bulk payload
+    // such as vertices or matrices goes into a separate data area and is
+    // referenced by offset, so recording never allocates once the buffers have
+    // grown to their steady state size.
+    class RenderCommandBuffer : utils::NotCopyable
+    {
+    public:
+        static constexpr uint32_t ALIGNMENT = 16;
+
+        RenderCommandBuffer() = default;
+
+        // Keeps capacity, only rewinds the write heads
+        void reset();
+
+        template<typename T>
+        T& push(const T& inCommand)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Render commands must be POD");
+            void* destination = allocateCommand(T::TYPE, static_cast<uint32_t>(sizeof(T)));
+            return *new (destination) T(inCommand);
+        }
+
+        // Reserves payload space. The pointer is invalidated by the next allocation.
+        void* allocateData(uint32_t inSize, uint32_t& outOffset);
+        uint32_t pushData(const void* inData, uint32_t inSize);
+        const void* getData(uint32_t inOffset) const;
+
+        // Calls inFunction(header, payload) for every command in recording order
+        template<typename Function>
+        void forEach(Function&& inFunction) const
+        {
+            uint32_t offset = 0;
+            while (offset < mCommandHead) {
+                const auto* header = reinterpret_cast<const RenderCommandHeader*>(mCommands.data() + offset);
+                inFunction(*header, mCommands.data() + offset + HEADER_SIZE);
+                offset += header->size;
+            }
+        }
+
+        // Simulation time the recorded state belongs to
+        void setTimestamp(std::chrono::steady_clock::time_point inTimestamp);
+        std::chrono::steady_clock::time_point getTimestamp() const;
+
+        uint32_t getCommandCount() const;
+        uint32_t getCommandBytes() const;
+        uint32_t getDataBytes() const;
+
+    private:
+        static constexpr uint32_t HEADER_SIZE =
+            (sizeof(RenderCommandHeader) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+        void* allocateCommand(RenderCommandType inType, uint32_t inSize);
+        static uint32_t grow(std::vector<uint8_t>& inStorage, uint32_t& ioHead, uint32_t inSize);
+
+        std::vector<uint8_t> mCommands;
+        std::vector<uint8_t> mData;
+        uint32_t mCommandHead{ 0 };
+        uint32_t mDataHead{ 0 };
+        uint32_t mCommandCount{ 0 };
+        std::chrono::steady_clock::time_point mTimestamp;
+    };
+} // namespace sane::gfx
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include <saneengine/gfx/commands/rendercommandbuffer.hpp>
+#include <saneengine/utils/notcopyable.hpp>
+
+namespace sane::gfx
+{
+    // Double-buffered hand-off of command buffers from the simulation thread to
+    // the render thread. Frame N+1 is recorded while frame N is replayed; the
+    // simulation only waits when it would get two frames ahead.
+    class RenderCommandQueue : utils::NotCopyable
+    {
+    public:
+        static constexpr uint32_t BUFFER_COUNT = 2;
+
+        RenderCommandQueue() = default;
+
+        // Simulation side. beginRecording() waits for a free buffer and returns
+        // nullptr once the queue is shut down.
+        RenderCommandBuffer* beginRecording();
+        // Buffer between beginRecording() and submit(), nullptr otherwise
+        RenderCommandBuffer* getRecordingBuffer();
+        void submit();
+
+        // Render side. acquire() returns the oldest submitted buffer. It waits
+        // for one when inWait is set, and returns nullptr when there is none
+        // or once the queue is shut down.
+        const RenderCommandBuffer* acquire(bool inWait = true);
+        void release(const SubmitStats& inStats);
+
+        // Stats of the most recently replayed frame
+        SubmitStats getLastSubmitStats() const;
+
+        // Wakes both sides so their loops can exit
+        void shutdown();
+
+    private:
+        enum class SlotState : uint8_t
+        {
+            Free,
+            Recording,
+            Submitted,
+            Rendering,
+        };
+
+        RenderCommandBuffer mBuffers[BUFFER_COUNT];
+        SlotState mStates[BUFFER_COUNT]{};
+        uint32_t mRecordIndex{ 0 };
+        uint32_t mRenderIndex{ 0 };
+        bool mShutdown{ false };
+        SubmitStats mLastStats;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mCondition;
+    };
+} // namespace sane::gfx
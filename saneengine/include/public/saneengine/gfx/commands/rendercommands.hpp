@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "saneengine/gfx/buffers/uniformblocks.hpp"
+
+namespace sane::gfx
+{
+    enum class RenderCommandType : uint32_t
+    {
+        SetFrame,
+        UploadMesh,
+        ReleaseMesh,
+        SubmitInstances,
+        DrawBatch,
+    };
+
+    struct RenderCommandHeader
+    {
+        RenderCommandType type;
+        // Header plus payload, padded to RenderCommandBuffer::ALIGNMENT
+        uint32_t size;
+    };
+
+    // Camera and timing for the frame. The viewport is filled in on replay.
+    struct SetFrameCommand
+    {
+        static constexpr RenderCommandType TYPE = RenderCommandType::SetFrame;
+
+        FrameUniforms uniforms;
+    };
+
+    // Creates the GPU mesh for meshId, replacing any previous one. Vertex data
+    // (vertexCount * 3 floats) and VertexAttributes live in the data area.
+    struct UploadMeshCommand
+    {
+        static constexpr RenderCommandType TYPE = RenderCommandType::UploadMesh;
+
+        uint64_t meshId;
+        uint32_t vertexCount;
+        uint32_t vertexDataOffset;
+        uint32_t attributeDataOffset;
+        uint32_t attributeCount;
+    };
+
+    struct ReleaseMeshCommand
+    {
+        static constexpr RenderCommandType TYPE = RenderCommandType::ReleaseMesh;
+
+        uint64_t meshId;
+    };
+
+    // Model matrices (glm::mat4) of the frame, indexed by its DrawBatch commands.
+    // Recorded once per frame. The matching entity ids (uint32_t) let the
+    // render thread interpolate each instance between simulation snapshots.
+    struct SubmitInstancesCommand
+    {
+        static constexpr RenderCommandType TYPE = RenderCommandType::SubmitInstances;
+
+        uint32_t dataOffset;
+        uint32_t entityDataOffset;
+        uint32_t instanceCount;
+    };
+
+    // Draws are replayed in recording order, which should already group
+    // batches sharing a program and mesh
+    struct DrawBatchCommand
+    {
+        static constexpr RenderCommandType TYPE = RenderCommandType::DrawBatch;
+
+        uint64_t meshId;
+        uint32_t programId;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+
+    // What the render thread actually submitted for a frame
+    struct SubmitStats
+    {
+        uint32_t drawCalls{ 0 };
+        uint32_t instances{ 0 };
+        // Binds actually issued, redundant ones are skipped
+        uint32_t programBinds{ 0 };
+        uint32_t vertexArrayBinds{ 0 };
+        uint32_t bufferBinds{ 0 };
+    };
+
+    static_assert(std::is_trivially_copyable_v<SetFrameCommand>);
+    static_assert(std::is_trivially_copyable_v<UploadMeshCommand>);
+    static_assert(std::is_trivially_copyable_v<DrawBatchCommand>);
+} // namespace sane::gfx
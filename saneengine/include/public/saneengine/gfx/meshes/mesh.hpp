@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "saneengine/gfx/buffers/vertexattribute.hpp"
+#include "saneengine/gfx/buffers/vertexbuffer.hpp"
+#include <saneengine/utils/notcopyable.hpp>
+
+namespace sane::gfx
+{
+    // GPU resident geometry: vertex data is uploaded once and its attribute
+    // layout is recorded in a dedicated vertex array object.
+    class Mesh : utils::NotCopyable
+    {
+    public:
+        Mesh(const float* inVertices, uint32_t inVertexCount, const std::vector<VertexAttribute>& inAttributes);
+        virtual ~Mesh();
+
+        virtual void bind() const;
+        virtual void unbind() const;
+
+        GLuint getVertexArray() const;
+        uint32_t getVertexCount() const;
+
+    protected:
+        GLuint mVertexArray;
+        std::unique_ptr<VertexBuffer> mVertexBuffer;
+        uint32_t mVertexCount;
+    };
+} // namespace sane::gfx
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "saneengine/gfx/buffers/vertexattribute.hpp"
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+
+namespace sane::gfx
+{
+    // Immutable CPU copy of a mesh, shared by every handle to it
+    struct MeshData
+    {
+        // Tightly packed positions, three floats per vertex
+        std::vector<float> vertices;
+        size_t vertexCount;
+        std::vector<VertexAttribute> attributes;
+        // Content hash, unique among the meshes stored at the same time
+        uint64_t hash;
+        // Bounds of the positions, zero for an empty mesh
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    // Ref-counted reference to geometry in the MeshRegistry. Copies share the
+    // data; the registry drops it when the last handle goes away.
+    class SANEENGINE_API MeshHandle
+    {
+    public:
+        MeshHandle() = default;
+        MeshHandle(const MeshHandle& inOther);
+        MeshHandle(MeshHandle&& inOther) noexcept;
+        MeshHandle& operator=(const MeshHandle& inOther);
+        MeshHandle& operator=(MeshHandle&& inOther) noexcept;
+        ~MeshHandle();
+
+        const MeshData* get() const;
+        const MeshData* operator->() const { return get(); }
+        explicit operator bool() const { return mEntry != nullptr; }
+
+    private:
+        friend class MeshRegistry;
+        struct Entry;
+
+        explicit MeshHandle(Entry* inEntry) : mEntry(inEntry) {}
+
+        Entry* mEntry{ nullptr };
+    };
+
+    // Stores each distinct mesh once, keyed by a hash of its vertices and
+    // attributes. Spawning many entities from the same geometry then costs a
+    // reference count each, and the renderer uploads it to the GPU once.
+    class SANEENGINE_API MeshRegistry : utils::NotCopyable
+    {
+    public:
+        static MeshRegistry& get();
+
+        // Returns a handle to identical stored geometry, or stores a copy of it
+        MeshHandle acquire(const float* inVertices, size_t inVertexCount, const std::vector<VertexAttribute>& inAttributes);
+
+        // Distinct meshes currently stored
+        size_t size() const;
+
+    private:
+        friend class MeshHandle;
+
+        MeshRegistry();
+        ~MeshRegistry();
+
+        void release(MeshHandle::Entry* inEntry);
+
+        class Impl;
+        Impl* mImpl;
+    };
+} // namespace sane::gfx
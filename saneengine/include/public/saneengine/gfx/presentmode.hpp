@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sane::gfx {
+    // How finished frames are shown. Headless windows never present, so
+    // they ignore it and always run uncapped.
+    enum class PresentMode : uint8_t {
+        // No vsync: lowest latency, frames may tear
+        Immediate,
+        // Waits for vertical blank, a late frame waits for the next one
+        VSync,
+        // Vsync while on time, a late frame is shown at once and may tear.
+        // Falls back to VSync where the driver lacks swap_control_tear.
+        AdaptiveVSync
+    };
+}
@@ -12,6 +12,7 @@
 #include <saneengine/utils/api.hpp>
 #include <saneengine/utils/notcopyable.hpp>
 #include <saneengine/gfx/shaders/shadertype.hpp>
+#include <saneengine/gfx/shaders/shaderreflection.hpp>
 
 namespace sane::gfx {
     using ShaderData = std::pair<ShaderType, std::string>;
@@ -23,6 +24,14 @@ namespace sane::gfx {
         virtual ~ShaderProgram();
 
         uint32_t getProgramId() const;
+        // Unique for every program linked, unlike GL ids which are reused once deleted
+        uint64_t getSerial() const;
+
+        // The ShaderProgram owning a GL program id, nullptr for programs made elsewhere
+        static ShaderProgram* find(uint32_t inProgramId);
+        // glUseProgram for any program id. Keeps the bound program the value
+        // caches check against right, so use it instead of the raw call.
+        static void use(uint32_t inProgramId);
 
         void bind() const;
         void unbind() const;
@@ -30,6 +39,9 @@ namespace sane::gfx {
         int32_t getAttribLocation(const char* inAttrib) const;
         int32_t getUniformLocation(const char* inUniform) const;
 
+        const ShaderReflection& getReflection() const;
+        UniformHandle getUniformHandle(const char* inUniform) const;
+
         void setUniform(const char* inUniform, int inValue);
         void setUniform(const char* inUniform, int inCount, int* inData);
         void setUniform(const char* inUniform, unsigned int inValue);
@@ -39,6 +51,17 @@ namespace sane::gfx {
         void setUniform(const char* inUniform, const glm::vec4& inValue);
         void setUniform(const char* inUniform, const glm::mat4& inValue);
 
+        // Handle based setters skip the GL call when the value is unchanged,
+        // across binds. The program must be the bound one.
+        void setUniform(UniformHandle inUniform, int inValue);
+        void setUniform(UniformHandle inUniform, int inCount, int* inData);
+        void setUniform(UniformHandle inUniform, unsigned int inValue);
+        void setUniform(UniformHandle inUniform, float inValue);
+        void setUniform(UniformHandle inUniform, const glm::vec2& inValue);
+        void setUniform(UniformHandle inUniform, const glm::vec3& inValue);
+        void setUniform(UniformHandle inUniform, const glm::vec4& inValue);
+        void setUniform(UniformHandle inUniform, const glm::mat4& inValue);
+
     private:
         class Impl;
         Impl* mImpl;
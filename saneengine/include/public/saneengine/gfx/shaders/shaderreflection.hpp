@@ -0,0 +1,77 @@
+#pragma once
+
+// STL headers
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Public headers
+#include <saneengine/utils/api.hpp>
+#include <saneengine/utils/notcopyable.hpp>
+
+namespace sane::gfx {
+    struct UniformInfo {
+        std::string name;
+        int32_t location;
+        uint32_t type;
+        int32_t arraySize;
+        // -1 for default block uniforms
+        int32_t blockIndex;
+        int32_t blockOffset;
+    };
+
+    struct AttributeInfo {
+        std::string name;
+        int32_t location;
+        uint32_t type;
+        int32_t arraySize;
+    };
+
+    struct UniformBlockInfo {
+        std::string name;
+        uint32_t index;
+        int32_t dataSize;
+        int32_t binding;
+    };
+
+    // Pre-resolved uniform that callers can store and reuse without lookups
+    struct UniformHandle {
+        static constexpr uint32_t INVALID_SLOT = ~0u;
+
+        int32_t location{ -1 };
+        uint32_t slot{ INVALID_SLOT };
+
+        bool isValid() const { return location >= 0; }
+    };
+
+    // Active uniforms, attributes and uniform blocks of a linked program, read
+    // once and kept in hashed tables so lookups never reach the driver.
+    class SANEENGINE_API ShaderReflection : utils::NotCopyable {
+    public:
+        explicit ShaderReflection(uint32_t inProgram);
+        ShaderReflection(ShaderReflection&& other) noexcept;
+        ~ShaderReflection();
+
+        uint32_t getProgramId() const;
+
+        const UniformInfo* findUniform(std::string_view inName) const;
+        const AttributeInfo* findAttribute(std::string_view inName) const;
+        const UniformBlockInfo* findUniformBlock(std::string_view inName) const;
+
+        UniformHandle getUniformHandle(std::string_view inName) const;
+        int32_t getUniformLocation(std::string_view inName) const;
+        int32_t getAttribLocation(std::string_view inName) const;
+
+        const std::vector<UniformInfo>& getUniforms() const;
+        const std::vector<AttributeInfo>& getAttributes() const;
+        const std::vector<UniformBlockInfo>& getUniformBlocks() const;
+
+        // Size in bytes of a single element of a GL uniform type
+        static uint32_t getTypeSize(uint32_t inType);
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+} // namespace sane::gfx
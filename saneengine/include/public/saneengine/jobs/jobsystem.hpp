@@ -0,0 +1,165 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sane::jobs {
+    // Fork-join counter. Every job started with it holds it open until done;
+    // JobSystem::wait() runs other jobs until it drops to zero. The first
+    // exception thrown by one of its jobs is rethrown from wait().
+    class SANEENGINE_API JobCounter : utils::NotCopyable {
+    public:
+        JobCounter() = default;
+
+        bool isDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> mPending{ 0 };
+        std::atomic<bool> mFailed{ false };
+        std::exception_ptr mError;
+    };
+
+    // Work-stealing job system. Every thread that starts jobs gets its own
+    // lock-free deque; idle workers steal from the others. Jobs come from
+    // per-thread pools and store small callables inline, so starting one does
+    // not allocate in steady state.
+    class SANEENGINE_API JobSystem : utils::NotCopyable {
+    public:
+        // Callables up to this size are stored in the job itself
+        static constexpr size_t INLINE_SIZE = 48;
+
+        // workerCount of 0 picks hardware_concurrency() - 1
+        explicit JobSystem(uint32_t workerCount = 0);
+        // Runs the jobs still queued before the workers stop
+        ~JobSystem();
+
+        // Engine wide instance, the first one constructed. Application owns it;
+        // nullptr when none exists, callers then run their work inline.
+        static JobSystem* get();
+
+        // Queues fn on the calling thread's deque. A job without a counter
+        // must not throw.
+        template<typename Fn>
+        void run(Fn&& fn, JobCounter* counter = nullptr);
+
+        // The calling thread runs queued jobs while it waits
+        void wait(JobCounter& counter);
+
+        // Calls fn(first, count) over [0, size) in pieces of at most grain
+        // and returns once all are done. Ranges are split in halves, so
+        // thieves take large pieces and the caller keeps the small ones.
+        template<typename Fn>
+        void parallelFor(size_t size, size_t grain, Fn&& fn);
+
+        uint32_t getWorkerCount() const;
+
+        // Threads that may take part in jobs: the workers plus a few that start them.
+        // A thread's slot is handed back when it exits.
+        uint32_t getThreadCapacity() const;
+        // Slot of the calling thread below getThreadCapacity(), stable for its lifetime
+        uint32_t getThreadIndex();
+
+    private:
+        struct Job {
+            void (*invoke)(Job& job);
+            JobCounter* counter;
+            Job* next;
+            void* owner;
+            alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+        };
+
+        Job* allocateJob();
+        void submit(Job* job);
+
+        template<typename Fn>
+        void splitRange(size_t first, size_t size, size_t grain, Fn& fn, JobCounter& counter);
+
+        class Impl;
+        Impl* mImpl;
+    };
+
+    template<typename Fn>
+    void JobSystem::run(Fn&& fn, JobCounter* counter) {
+        using Callable = std::decay_t<Fn>;
+
+        Job* job = allocateJob();
+        if constexpr (sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)) {
+            new (job->storage) Callable(std::forward<Fn>(fn));
+            job->invoke = [](Job& self) {
+                auto* callable = std::launder(reinterpret_cast<Callable*>(self.storage));
+                struct Destroy {
+                    Callable* callable;
+                    ~Destroy() { callable->~Callable(); }
+                } destroy{ callable };
+                (*callable)();
+            };
+        }
+        else {
+            new (job->storage) Callable*(new Callable(std::forward<Fn>(fn)));
+            job->invoke = [](Job& self) {
+                std::unique_ptr<Callable> callable(*std::launder(reinterpret_cast<Callable**>(self.storage)));
+                (*callable)();
+            };
+        }
+
+        job->counter = counter;
+        if (counter) {
+            counter->mPending.fetch_add(1, std::memory_order_relaxed);
+        }
+        submit(job);
+    }
+
+    template<typename Fn>
+    void JobSystem::parallelFor(size_t size, size_t grain, Fn&& fn) {
+        grain = std::max<size_t>(grain, 1);
+        if (size <= grain || getWorkerCount() == 0) {
+            if (size > 0) {
+                fn(size_t{ 0 }, size);
+            }
+            return;
+        }
+
+        // Jobs refer to the counter and fn on this stack, so they are waited for even on failure
+        JobCounter counter;
+        std::exception_ptr error;
+        try {
+            splitRange(0, size, grain, fn, counter);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        if (error) {
+            try {
+                wait(counter);
+            }
+            catch (...) {
+            }
+            std::rethrow_exception(error);
+        }
+        wait(counter);
+    }
+
+    template<typename Fn>
+    void JobSystem::splitRange(size_t first, size_t size, size_t grain, Fn& fn, JobCounter& counter) {
+        while (size > grain) {
+            size_t half = size / 2;
+            run([this, &fn, &counter, grain, upper = first + half, upperSize = size - half] {
+                splitRange(upper, upperSize, grain, fn, counter);
+            }, &counter);
+            size = half;
+        }
+        fn(first, size);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "saneengine/jobs/jobsystem.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace sane::jobs {
+    // One State per thread, for reductions inside jobs without locking. Jobs
+    // work on local(); once they are done the caller merges with forEach().
+    // States persist between passes, so buffers in them keep their capacity.
+    template<typename State>
+    class PerThread {
+    public:
+        // Sizes the slots for the current JobSystem, call before starting the jobs
+        void prepare() {
+            auto* jobSystem = JobSystem::get();
+            size_t capacity = jobSystem ? jobSystem->getThreadCapacity() : 1;
+            if (mSlots.size() < capacity) {
+                mSlots.resize(capacity);
+            }
+        }
+
+        State& local() {
+            auto* jobSystem = JobSystem::get();
+            return mSlots[jobSystem ? jobSystem->getThreadIndex() : 0].state;
+        }
+
+        template<typename Fn>
+        void forEach(Fn&& fn) {
+            for (auto& slot : mSlots) {
+                fn(slot.state);
+            }
+        }
+
+    private:
+        // Slots are written by different threads, keep them off each other's cache lines
+        struct alignas(64) Slot {
+            State state{};
+        };
+
+        std::vector<Slot> mSlots;
+    };
+}
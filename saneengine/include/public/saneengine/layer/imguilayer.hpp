@@ -15,9 +15,12 @@ namespace sane {
 
         void onAttach() override;
         void onDetach() override;
-        void onUpdate(float deltaTime) override;
         void onRender() final override;
 
+        // Build ImGui windows here. Called from onRender between the ImGui
+        // begin and end of frame, since ImGui has to stay on the render thread.
+        virtual void onImGui() {}
+
     private:
         class Impl;
         Impl* mImpl;
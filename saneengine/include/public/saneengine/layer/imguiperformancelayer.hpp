@@ -7,7 +7,7 @@ namespace sane {
         ImGuiPerformanceLayer(const char* name = "ImGui Performance Layer", int32_t priority = -1);
         ~ImGuiPerformanceLayer() override;
 
-        void onUpdate(float deltaTime) override;
+        void onImGui() override;
 
     private:
         class Impl;
@@ -4,6 +4,7 @@
 
 #include "saneengine/utils/api.hpp"
 #include "saneengine/utils/notcopyable.hpp"
+#include "saneengine/utils/timings.hpp"
 
 namespace sane {
     class SANEENGINE_API Layer : public utils::NotCopyable {
@@ -11,6 +12,10 @@ namespace sane {
         Layer(const char* name = "Layer", int32_t priority = 0);
         virtual ~Layer();
 
+        // onAttach, onDetach and onRender run on the render thread with the GL
+        // context current. onUpdate runs on the simulation thread, concurrently
+        // with the previous frame's onRender. Both threads may take transient
+        // memory from utils::FrameArena::get(), it is reset every frame.
         virtual void onAttach() {}
         virtual void onDetach() {}
         virtual void onUpdate(float deltaTime) {}
@@ -20,6 +25,11 @@ namespace sane {
         int32_t getPriority() const;
         void setPriority(int32_t priority);
 
+        // onUpdate and onRender durations, recorded by Application.
+        // nullptr when timings are compiled out.
+        utils::TimingTrack* getUpdateTiming() const;
+        utils::TimingTrack* getRenderTiming() const;
+
     private:
         class Impl;
         Impl* mImpl;
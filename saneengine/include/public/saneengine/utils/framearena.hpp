@@ -0,0 +1,61 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <cstddef>
+#include <memory_resource>
+
+namespace sane::utils {
+    // Bump allocator for memory that only lives until the end of the frame.
+    // Each thread has its own, so allocating takes no lock; deallocating does
+    // nothing and reset() releases everything at once. Containers use it
+    // through std::pmr, e.g. std::pmr::vector<float> v(&FrameArena::get()).
+    //
+    // Application resets the simulation thread's arena before every tick and
+    // the render thread's before every frame. Every job runs in a Scope, so
+    // what a job allocates is released when it finishes.
+    class SANEENGINE_API FrameArena : public std::pmr::memory_resource, public NotCopyable {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+        explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+        ~FrameArena() override;
+
+        // The calling thread's arena
+        static FrameArena& get();
+
+        // Releases everything and returns the peak usage since the last reset,
+        // in bytes. The memory is kept; when the frame spilled over into more
+        // blocks, they are merged into one that fits it.
+        size_t reset();
+
+        // Bytes handed out, including alignment padding and skipped block tails
+        size_t getUsage() const;
+        // Peak usage of the last frame that was reset, readable from any thread
+        size_t getLastFramePeak() const;
+        size_t getCapacity() const;
+
+        // Releases what was allocated while it was alive, for scratch memory
+        // within a frame. Scopes nest and must end in reverse order.
+        class SANEENGINE_API Scope : public NotCopyable {
+        public:
+            explicit Scope(FrameArena& arena);
+            ~Scope();
+
+        private:
+            FrameArena& mArena;
+            size_t mBlock;
+            size_t mOffset;
+            size_t mUsage;
+        };
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
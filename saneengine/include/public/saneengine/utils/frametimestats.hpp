@@ -0,0 +1,54 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace sane::utils {
+    // Frame time statistics of one window, times in seconds
+    struct FrameTimeSnapshot {
+        uint32_t frameCount{ 0 };
+        float average{ 0.0f };
+        float median{ 0.0f };
+        float p99{ 0.0f };
+        float p999{ 0.0f };
+        float max{ 0.0f };
+
+        float getAverageFps() const { return average > 0.0f ? 1.0f / average : 0.0f; }
+        // Frame rate the slowest 1% and 0.1% of frames stay below
+        float getOnePercentLow() const { return p99 > 0.0f ? 1.0f / p99 : 0.0f; }
+        float getPointOnePercentLow() const { return p999 > 0.0f ? 1.0f / p999 : 0.0f; }
+    };
+
+    // Frame time percentiles over sliding windows. Samples are counted in
+    // log-scale buckets, 16 per power of two, so adding one is O(1) and a
+    // percentile is accurate to a few percent. Every window is split into
+    // slices that expire whole as it slides. One thread adds samples and
+    // publishes; any thread may read the published snapshots without locking.
+    class SANEENGINE_API FrameTimeStats : public NotCopyable {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Window lengths in seconds
+        explicit FrameTimeStats(std::initializer_list<float> windows = { 1.0f, 10.0f, 60.0f });
+        ~FrameTimeStats();
+
+        void add(float frameTime, Clock::time_point now = Clock::now());
+
+        // Computes every window's snapshot for getSnapshot(), O(buckets)
+        void publish(Clock::time_point now = Clock::now());
+
+        size_t getWindowCount() const;
+        float getWindowLength(size_t window) const;
+
+        // Snapshot of the last publish(), safe from any thread
+        FrameTimeSnapshot getSnapshot(size_t window) const;
+
+    private:
+        class Impl;
+        Impl* mImpl;
+    };
+}
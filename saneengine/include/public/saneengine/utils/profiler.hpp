@@ -0,0 +1,75 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Set by the SANEENGINE_ENABLE_PROFILER CMake option
+#ifndef SANEENGINE_PROFILER
+#define SANEENGINE_PROFILER 1
+#endif
+
+namespace sane::utils {
+    // Timeline of named scopes on every thread, written as Chrome trace JSON
+    // for chrome://tracing or ui.perfetto.dev. Outside a capture a scope costs
+    // one relaxed load; during one each thread appends to its own buffer.
+    class SANEENGINE_API Profiler : public NotCopyable {
+    public:
+        static Profiler& get();
+
+        // Names the calling thread in captures
+        void setThreadName(std::string name);
+
+        void beginCapture();
+        // Stops the capture and writes it to path, throws when that fails.
+        // Returns the number of events written.
+        size_t endCapture(const char* path);
+
+        bool isCapturing() const { return mCapturing.load(std::memory_order_relaxed); }
+
+        // name must outlive the capture, SANE_PROFILE_SCOPE passes string literals
+        void record(const char* name, std::chrono::steady_clock::time_point start,
+            std::chrono::steady_clock::time_point end);
+
+    private:
+        Profiler();
+        ~Profiler();
+
+        std::atomic<bool> mCapturing{ false };
+
+        class Impl;
+        Impl* mImpl;
+    };
+
+    class ProfileScope : public NotCopyable {
+    public:
+        explicit ProfileScope(const char* name) {
+            if (Profiler::get().isCapturing()) {
+                mName = name;
+                mStart = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ProfileScope() {
+            if (mName) {
+                Profiler::get().record(mName, mStart, std::chrono::steady_clock::now());
+            }
+        }
+
+    private:
+        const char* mName{ nullptr };
+        std::chrono::steady_clock::time_point mStart;
+    };
+}
+
+#if SANEENGINE_PROFILER
+#define SANE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SANE_PROFILE_CONCAT(a, b) SANE_PROFILE_CONCAT_IMPL(a, b)
+#define SANE_PROFILE_SCOPE(name) ::sane::utils::ProfileScope SANE_PROFILE_CONCAT(saneProfileScope, __LINE__)(name)
+#define SANE_PROFILE_THREAD(name) ::sane::utils::Profiler::get().setThreadName(name)
+#else
+#define SANE_PROFILE_SCOPE(name) ((void)0)
+#define SANE_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "saneengine/utils/api.hpp"
+#include "saneengine/utils/notcopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Set by the SANEENGINE_ENABLE_TIMINGS CMake option
+#ifndef SANEENGINE_TIMINGS
+#define SANEENGINE_TIMINGS 1
+#endif
+
+namespace sane::utils {
+    inline constexpr bool TIMINGS_ENABLED = SANEENGINE_TIMINGS != 0;
+
+    enum class TimingKind : uint8_t {
+        System,
+        LayerUpdate,
+        LayerRender,
+        // CPU and GPU time of the render thread's passes
+        RenderPass,
+        GpuPass
+    };
+
+    // Ring buffer of the last durations of one system or layer callback. A
+    // track has a single writer; readers on other threads may see a sample
+    // being replaced but never block it.
+    class TimingTrack : public NotCopyable {
+    public:
+        static constexpr uint32_t CAPACITY = 128;
+
+        TimingTrack(std::string name, TimingKind kind) : mName(std::move(name)), mKind(kind) {}
+
+        void record(std::chrono::nanoseconds duration) {
+            auto nanoseconds = std::min<int64_t>(duration.count(), UINT32_MAX);
+            uint32_t index = mCount.load(std::memory_order_relaxed);
+            mSamples[index % CAPACITY].store(static_cast<uint32_t>(nanoseconds), std::memory_order_relaxed);
+            mCount.store(index + 1, std::memory_order_release);
+        }
+
+        // Appends the samples held, oldest first, in microseconds
+        void copySamples(std::vector<float>& out) const {
+            uint32_t count = mCount.load(std::memory_order_acquire);
+            for (uint32_t i = count - std::min(count, CAPACITY); i < count; ++i) {
+                out.push_back(mSamples[i % CAPACITY].load(std::memory_order_relaxed) / 1000.0f);
+            }
+        }
+
+        const std::string& getName() const { return mName; }
+        TimingKind getKind() const { return mKind; }
+
+    private:
+        std::string mName;
+        TimingKind mKind;
+        std::atomic<uint32_t> mCount{ 0 };
+        std::atomic<uint32_t> mSamples[CAPACITY]{};
+    };
+
+    // Summary of one track, times in microseconds
+    struct TimingStats {
+        std::string name;
+        TimingKind kind;
+        float average;
+        float p99;
+        float max;
+        std::vector<float> history;
+    };
+
+    // Every live timing track. Systems and layers add theirs when constructed.
+    class SANEENGINE_API Timings : public NotCopyable {
+    public:
+        static Timings& get();
+
+        // nullptr when timings are compiled out
+        std::shared_ptr<TimingTrack> addTrack(std::string name, TimingKind kind);
+        void removeTrack(const TimingTrack* track);
+
+        // Tracks without samples are left out
+        std::vector<TimingStats> query() const;
+
+    private:
+        Timings();
+        ~Timings();
+
+        class Impl;
+        Impl* mImpl;
+    };
+
+    // Records the time until the end of the scope into track, if there is one
+    class ScopedTiming : public NotCopyable {
+    public:
+        explicit ScopedTiming(TimingTrack* track) {
+            if constexpr (TIMINGS_ENABLED) {
+                mTrack = track;
+                if (track) mStart = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTiming() {
+            if constexpr (TIMINGS_ENABLED) {
+                if (mTrack) mTrack->record(std::chrono::steady_clock::now() - mStart);
+            }
+        }
+
+    private:
+        TimingTrack* mTrack{ nullptr };
+        std::chrono::steady_clock::time_point mStart;
+    };
+}
@@ -1,125 +1,389 @@
 #include "saneengine/application.hpp"
 #include "saneengine/ecs/system.hpp"
 #include "saneengine/ecs/systemmanager.hpp"
+#include "saneengine/gfx/commands/rendercommandexecutor.hpp"
+#include "saneengine/gfx/commands/rendercommandqueue.hpp"
+#include "saneengine/gfx/queries/gputimer.hpp"
+#include "saneengine/gfx/sync/framepacer.hpp"
+#include "saneengine/jobs/jobsystem.hpp"
 #include "saneengine/layer/layerstack.hpp"
+#include "saneengine/utils/framearena.hpp"
+#include "saneengine/utils/profiler.hpp"
+#include "saneengine/utils/timings.hpp"
 #include "saneengine/window.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <string_view>
 #include <thread>
 
 #include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
 
 #include "saneengine/layer/layer.hpp"
 #include "saneengine/utils/uuid.hpp"
 
 namespace sane {
+    namespace {
+        // Render pass names, shared by the CPU and GPU timing tracks
+        constexpr const char* REPLAY_PASS = "Command replay";
+        constexpr const char* DRAW_PASS = "Scene draw";
+
+        // SANE_HEADLESS set to anything but 0 forces headless mode
+        bool isHeadlessRequested() {
+            const char* value = std::getenv("SANE_HEADLESS");
+            return value && *value && std::string_view(value) != "0";
+        }
+    }
+
     class Application::Impl {
     public:
+        // First so it outlives everything that may still have jobs in flight
+        std::unique_ptr<jobs::JobSystem> jobSystem;
         std::unique_ptr<Window> window;
         std::unique_ptr<LayerStack> layerStack;
         std::unique_ptr<ecs::SystemManager> systemManager;
+        std::unique_ptr<gfx::RenderCommandQueue> commandQueue;
         std::thread renderThread;
+        std::thread simulationThread;
         std::chrono::steady_clock::time_point lastFrameTime;
+
+        // Held while a frame is simulated. Guards the registry, the systems and
+        // changes to the layer list, which only the render thread makes.
+        std::mutex simulationMutex;
+
+        std::mutex pendingMutex;
         std::vector<std::unique_ptr<Layer>> pendingLayers;
-        bool running{ true };
+        uint32_t pendingPops{ 0 };
+
+        std::atomic<bool> running{ true };
+
+        // Seconds per simulation tick, 0 for one tick per presented frame
+        std::atomic<float> fixedStep{ 0.0f };
+        std::atomic<uint32_t> maxCatchUpTicks{ 4 };
+
+        // Frame pacing, picked up by the render thread at the start of a frame
+        std::atomic<gfx::PresentMode> presentMode{ gfx::PresentMode::VSync };
+        std::atomic<float> targetFrameTime{ 0.0f };
+        std::atomic<uint32_t> maxQueuedFrames{ 0 };
+
+        // Frame arena peaks of the last tick and the last rendered frame
+        std::atomic<size_t> simulationArenaPeak{ 0 };
+        std::atomic<size_t> renderArenaPeak{ 0 };
+
+        // CPU side of the render passes the GpuTimer measures on the GPU
+        std::shared_ptr<utils::TimingTrack> replayTiming;
+        std::shared_ptr<utils::TimingTrack> drawTiming;
+
+        // Layers attach on the render thread so onAttach can create GL objects,
+        // with the simulation paused between frames
+        void applyPendingLayers() {
+            std::vector<std::unique_ptr<Layer>> layers;
+            uint32_t pops = 0;
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                if (pendingLayers.empty() && !pendingPops) return;
+                layers.swap(pendingLayers);
+                std::swap(pops, pendingPops);
+            }
+
+            std::lock_guard<std::mutex> lock(simulationMutex);
+            for (; pops > 0 && !layerStack->getLayers().empty(); --pops) {
+                layerStack->popLayer();
+            }
+            for (auto& layer : layers) {
+                layerStack->pushLayer(std::move(layer));
+            }
+        }
+
+        void stopThreads() {
+            running = false;
+            commandQueue->shutdown();
+            if (simulationThread.joinable()) {
+                simulationThread.join();
+            }
+            if (renderThread.joinable()) {
+                renderThread.join();
+            }
+        }
     };
 
-    Application::Application(const char* title, uint32_t width, uint32_t height)
+    Application::Application(const char* title, uint32_t width, uint32_t height, bool headless)
         : mImpl(new Impl)
     {
-        mImpl->window = std::make_unique<Window>(title, width, height);
+        mImpl->jobSystem = std::make_unique<jobs::JobSystem>();
+        mImpl->window = std::make_unique<Window>(title, width, height, headless || isHeadlessRequested());
         mImpl->layerStack = std::make_unique<LayerStack>();
         mImpl->systemManager = std::make_unique<ecs::SystemManager>();
+        mImpl->commandQueue = std::make_unique<gfx::RenderCommandQueue>();
         mImpl->lastFrameTime = std::chrono::steady_clock::now();
+        mImpl->replayTiming = utils::Timings::get().addTrack(REPLAY_PASS, utils::TimingKind::RenderPass);
+        mImpl->drawTiming = utils::Timings::get().addTrack(DRAW_PASS, utils::TimingKind::RenderPass);
+
+        // Systems find the queue they record into through the registry context
+        mImpl->systemManager->getRegistry().ctx().emplace<gfx::RenderCommandQueue*>(mImpl->commandQueue.get());
 
         mImpl->systemManager->startup();
         setupRenderThread();
     }
 
     Application::~Application() {
+        mImpl->stopThreads();
         mImpl->systemManager->shutdown();
+        for (const auto& timing : { mImpl->replayTiming, mImpl->drawTiming }) {
+            if (timing) {
+                utils::Timings::get().removeTrack(timing.get());
+            }
+        }
         delete mImpl;
     }
 
     void Application::pushLayer(std::unique_ptr<Layer> layer) {
+        std::lock_guard<std::mutex> lock(mImpl->pendingMutex);
         mImpl->pendingLayers.push_back(std::move(layer));
     }
 
     void Application::popLayer() {
-        mImpl->layerStack->popLayer();
+        std::lock_guard<std::mutex> lock(mImpl->pendingMutex);
+        ++mImpl->pendingPops;
+    }
+
+    void Application::setFixedUpdateRate(float ticksPerSecond, uint32_t maxCatchUpTicks) {
+        mImpl->fixedStep = ticksPerSecond > 0.0f ? 1.0f / ticksPerSecond : 0.0f;
+        mImpl->maxCatchUpTicks = std::max(maxCatchUpTicks, 1u);
+    }
+
+    void Application::setPresentMode(gfx::PresentMode mode) {
+        mImpl->presentMode = mode;
+    }
+
+    void Application::setFrameLimit(float framesPerSecond) {
+        mImpl->targetFrameTime = framesPerSecond > 0.0f ? 1.0f / framesPerSecond : 0.0f;
+    }
+
+    void Application::setMaxQueuedFrames(uint32_t frames) {
+        mImpl->maxQueuedFrames = frames;
     }
 
     void Application::run() {
         mainLoop();
     }
 
+    void Application::close() {
+        mImpl->window->close();
+    }
+
+    bool Application::isHeadless() const {
+        return mImpl->window->isHeadless();
+    }
+
     void Application::mainLoop() {
-        glfwMakeContextCurrent(nullptr);
+        setupSimulationThread();
 
+        SANE_PROFILE_THREAD("Main");
         while (!mImpl->window->shouldClose()) {
-            glfwPollEvents();
+            SANE_PROFILE_SCOPE("Application::pollEvents");
+            mImpl->window->pollEvents();
         }
 
-        mImpl->running = false;
-        if (mImpl->renderThread.joinable()) {
-            mImpl->renderThread.join();
-        }
+        mImpl->stopThreads();
     }
 
     void Application::setupRenderThread() {
-        if (!mImpl->window || !mImpl->window->getNativeWindow()) {
+        if (!mImpl->window) {
             throw std::runtime_error("Window not properly initialized");
         }
 
         mImpl->window->initializeGlad();
-        glfwMakeContextCurrent(nullptr);
+        mImpl->window->releaseContext();
 
         std::promise<void> contextReady;
         auto contextFuture = contextReady.get_future();
 
         mImpl->renderThread = std::thread([this, &contextReady]() {
-            glfwMakeContextCurrent(mImpl->window->getNativeWindow());
+            SANE_PROFILE_THREAD("Render");
 
+            // The promise lives on the constructor's stack, once set it may be gone
+            bool contextSignaled = false;
             try {
-                if (!mImpl->window->getNativeWindow()) {
-                    throw std::runtime_error("Invalid window handle in render thread");
-                }
-
+                mImpl->window->makeContextCurrent();
                 contextReady.set_value();
+                contextSignaled = true;
+
+                // Owns the GL resources commands refer to, so it lives on this thread
+                gfx::RenderCommandExecutor executor;
+                gfx::GpuTimer gpuTimer;
+                gfx::FramePacer framePacer;
+                gfx::SubmitStats stats;
+                // Windows start with vsync
+                auto presentMode = gfx::PresentMode::VSync;
 
                 while (mImpl->running) {
-                    auto currentTime = std::chrono::steady_clock::now();
-                    float deltaTime = std::chrono::duration<float>(
-                        currentTime - mImpl->lastFrameTime).count();
-                    mImpl->lastFrameTime = currentTime;
+                    SANE_PROFILE_SCOPE("Application::renderFrame");
+                    mImpl->renderArenaPeak = utils::FrameArena::get().reset();
+                    gpuTimer.beginFrame();
+                    if (auto mode = mImpl->presentMode.load(); mode != presentMode) {
+                        presentMode = mode;
+                        mImpl->window->setPresentMode(mode);
+                    }
+                    framePacer.setTargetFrameTime(mImpl->targetFrameTime);
+                    framePacer.setMaxQueuedFrames(mImpl->maxQueuedFrames);
+                    float step = mImpl->fixedStep;
+
+                    // Variable rate draws each simulated frame once. Fixed rate keeps
+                    // redrawing the latest snapshots until the next tick lands.
+                    bool wait = step <= 0.0f || !executor.hasSnapshot();
+                    const gfx::RenderCommandBuffer* commands;
+                    {
+                        SANE_PROFILE_SCOPE("Application::waitForCommands");
+                        commands = mImpl->commandQueue->acquire(wait);
+                    }
+                    if (!commands && wait) break;
+
+                    // Every buffer is applied, resource commands must not be skipped
+                    while (commands) {
+                        SANE_PROFILE_SCOPE("Application::replayCommands");
+                        utils::ScopedTiming timing(mImpl->replayTiming.get());
+                        gfx::GpuTimer::Scope gpuPass(gpuTimer, REPLAY_PASS);
+                        mImpl->applyPendingLayers();
+                        executor.apply(*commands);
+                        mImpl->commandQueue->release(stats);
+                        commands = step > 0.0f ? mImpl->commandQueue->acquire(false) : nullptr;
+                    }
+
+                    float alpha = 1.0f;
+                    if (step > 0.0f) {
+                        float sinceSnapshot = std::chrono::duration<float>(
+                            std::chrono::steady_clock::now() - executor.getSnapshotTime()).count();
+                        alpha = std::clamp(sinceSnapshot / step, 0.0f, 1.0f);
+                    }
+                    {
+                        SANE_PROFILE_SCOPE("Application::draw");
+                        utils::ScopedTiming timing(mImpl->drawTiming.get());
+                        gfx::GpuTimer::Scope gpuPass(gpuTimer, DRAW_PASS);
+                        stats = executor.draw(alpha);
+                    }
 
                     for (const auto& layer : mImpl->layerStack->getLayers()) {
-                        layer->onUpdate(deltaTime);
+                        utils::ScopedTiming timing(layer->getRenderTiming());
+                        gfx::GpuTimer::Scope gpuPass(gpuTimer, layer->getName());
                         layer->onRender();
                     }
 
-                    mImpl->systemManager->update(deltaTime);
-
-                    mImpl->window->swapBuffers();
+                    {
+                        SANE_PROFILE_SCOPE("Application::swapBuffers");
+                        mImpl->window->swapBuffers();
+                    }
+                    {
+                        SANE_PROFILE_SCOPE("Application::framePacing");
+                        framePacer.endFrame();
+                    }
                     glClearColor(0.4f, 0.6f, 1.0f, 1.0f);
                     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                }
+            }
+            catch (const std::exception&) {
+                if (!contextSignaled) {
+                    contextReady.set_exception(std::current_exception());
+                    return;
+                }
+                // Like a failing simulation thread, shut the application down
+                mImpl->running = false;
+                mImpl->window->close();
+                mImpl->commandQueue->shutdown();
+            }
+            });
+
+        contextFuture.get();
+    }
 
-                    for (auto& pendingLayer : mImpl->pendingLayers) {
-                        mImpl->layerStack->pushLayer(std::move(pendingLayer));
+    void Application::setupSimulationThread() {
+        mImpl->lastFrameTime = std::chrono::steady_clock::now();
+
+        mImpl->simulationThread = std::thread([this]() {
+            using Clock = std::chrono::steady_clock;
+            SANE_PROFILE_THREAD("Simulation");
+
+            try {
+                auto nextTick = Clock::now();
+                while (mImpl->running) {
+                    float step = mImpl->fixedStep;
+                    if (step <= 0.0f) {
+                        // Waits while the render thread is still replaying the frame before last
+                        gfx::RenderCommandBuffer* commands;
+                        {
+                            SANE_PROFILE_SCOPE("Application::waitForRender");
+                            commands = mImpl->commandQueue->beginRecording();
+                        }
+                        if (!commands) break;
+
+                        auto currentTime = Clock::now();
+                        float deltaTime = std::chrono::duration<float>(
+                            currentTime - mImpl->lastFrameTime).count();
+                        mImpl->lastFrameTime = currentTime;
+                        nextTick = currentTime;
+
+                        commands->setTimestamp(currentTime);
+                        simulateFrame(deltaTime);
+                        mImpl->commandQueue->submit();
+                        continue;
+                    }
+
+                    auto stepDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(step));
+                    auto currentTime = Clock::now();
+                    if (currentTime < nextTick) {
+                        std::this_thread::sleep_until(nextTick);
+                        continue;
+                    }
+
+                    // Ticks owed since the last one, capped so a long hitch cannot spiral
+                    auto owed = static_cast<uint32_t>((currentTime - nextTick) / stepDuration) + 1;
+                    uint32_t maxTicks = mImpl->maxCatchUpTicks;
+                    if (owed > maxTicks) {
+                        nextTick = currentTime - stepDuration * (maxTicks - 1);
+                        owed = maxTicks;
                     }
-                    mImpl->pendingLayers.clear();
+
+                    // Only the last tick records render commands, the others run without a buffer
+                    for (uint32_t tick = 0; tick < owed; ++tick) {
+                        bool presented = tick + 1 == owed;
+                        if (presented) {
+                            auto* commands = mImpl->commandQueue->beginRecording();
+                            if (!commands) return;
+                            commands->setTimestamp(nextTick);
+                        }
+
+                        simulateFrame(step);
+                        if (presented) {
+                            mImpl->commandQueue->submit();
+                        }
+                        nextTick += stepDuration;
+                    }
+                    mImpl->lastFrameTime = nextTick;
                 }
             }
             catch (const std::exception&) {
-                contextReady.set_exception(std::current_exception());
+                mImpl->window->close();
+                mImpl->commandQueue->shutdown();
             }
             });
+    }
 
-        contextFuture.get();
+    void Application::simulateFrame(float deltaTime) {
+        SANE_PROFILE_SCOPE("Application::simulateFrame");
+        mImpl->simulationArenaPeak = utils::FrameArena::get().reset();
+
+        std::lock_guard<std::mutex> lock(mImpl->simulationMutex);
+        for (const auto& layer : mImpl->layerStack->getLayers()) {
+            utils::ScopedTiming timing(layer->getUpdateTiming());
+            layer->onUpdate(deltaTime);
+        }
+
+        mImpl->systemManager->update(deltaTime);
     }
 
     utils::UUID Application::startSystem(std::unique_ptr<ecs::System> system) {
@@ -128,19 +392,35 @@ namespace sane {
         }
         utils::UUID systemId = utils::generateUUID();
         system->setId(systemId);
+
+        std::lock_guard<std::mutex> lock(mImpl->simulationMutex);
         mImpl->systemManager->addSystem(std::move(system));
         return systemId;
     }
 
     void Application::stopSystem(utils::UUID systemId) {
+        std::lock_guard<std::mutex> lock(mImpl->simulationMutex);
         mImpl->systemManager->removeSystem(systemId);
     }
 
     ecs::System* Application::getSystem(utils::UUID systemId) {
+        std::lock_guard<std::mutex> lock(mImpl->simulationMutex);
         return mImpl->systemManager->getSystem(systemId);
     }
 
+    size_t Application::getSimulationArenaPeak() const {
+        return mImpl->simulationArenaPeak;
+    }
+
+    size_t Application::getRenderArenaPeak() const {
+        return mImpl->renderArenaPeak;
+    }
+
+    jobs::JobSystem& Application::getJobSystem() {
+        return *mImpl->jobSystem;
+    }
+
     ecs::SystemManager& Application::getSystemManager() {
         return *mImpl->systemManager;
     }
-} // namespace sane
\ No newline at end of file
+} // namespace sane
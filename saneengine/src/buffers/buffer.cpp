@@ -19,6 +19,17 @@ namespace sane::gfx {
         glBindBuffer(mTargetType, 0);
     }
 
+    Buffer::Buffer(GLuint inTarget)
+        : mTargetType(inTarget)
+        , mBuffer(0)
+        , mSize(0)
+    {
+        glGenBuffers(1, &mBuffer);
+        if (!mBuffer) {
+            throw std::runtime_error("Failed to create buffer");
+        }
+    }
+
     Buffer::~Buffer() {
         if (mBuffer) {
             glDeleteBuffers(1, &mBuffer);
@@ -70,4 +81,12 @@ namespace sane::gfx {
         glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
     }
 
+    GLuint Buffer::getBufferId() const {
+        return mBuffer;
+    }
+
+    uint32_t Buffer::getSize() const {
+        return mSize;
+    }
+
 } // namespace sane::gfx
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "saneengine/gfx/buffers/streamingbuffer.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    // Mapping goes through the copy target so vertex array and uniform bindings stay untouched
+    constexpr GLenum MAP_TARGET = GL_COPY_WRITE_BUFFER;
+    constexpr GLuint64 FENCE_WAIT_NS = 1000000;
+}
+
+namespace sane::gfx {
+
+    StreamingBuffer::StreamingBuffer(GLuint inTarget, uint32_t inFrameSize)
+        : Buffer(inTarget)
+        , mFrameSize(inFrameSize)
+    {
+        mSize = mFrameSize * FRAME_COUNT;
+
+        glBindBuffer(MAP_TARGET, mBuffer);
+        if (GLAD_GL_ARB_buffer_storage && glBufferStorage) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(MAP_TARGET, mSize, nullptr, flags);
+            mMapping = static_cast<uint8_t*>(glMapBufferRange(MAP_TARGET, 0, mSize, flags));
+            if (!mMapping) {
+                glBindBuffer(MAP_TARGET, 0);
+                throw std::runtime_error("Failed to persistently map streaming buffer");
+            }
+            mPersistent = true;
+        }
+        else {
+            glBufferData(MAP_TARGET, mSize, nullptr, GL_STREAM_DRAW);
+        }
+        glBindBuffer(MAP_TARGET, 0);
+    }
+
+    StreamingBuffer::~StreamingBuffer() {
+        if (mMapping) {
+            glBindBuffer(MAP_TARGET, mBuffer);
+            glUnmapBuffer(MAP_TARGET);
+            glBindBuffer(MAP_TARGET, 0);
+            mMapping = nullptr;
+        }
+
+        for (auto& fence : mFences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+    }
+
+    void StreamingBuffer::update(uint32_t inSize, uint32_t inOffset, const void* inData) {
+        throw std::runtime_error("StreamingBuffer is only written through allocate() and write()");
+    }
+
+    void StreamingBuffer::move(uint32_t inSize, uint32_t inSrcOffset, uint32_t inDstOffset) {
+        throw std::runtime_error("StreamingBuffer is only written through allocate() and write()");
+    }
+
+    void StreamingBuffer::clone(Buffer& inBuffer) {
+        throw std::runtime_error("StreamingBuffer is only written through allocate() and write()");
+    }
+
+    void StreamingBuffer::mapCurrentRegion() {
+        if (!mPersistent && !mMapping) {
+            // Everything before mFlushedHead may already be queued for the GPU, so
+            // only the untouched tail of the region is mapped
+            mMappedFrom = mFlushedHead;
+            glBindBuffer(MAP_TARGET, mBuffer);
+            mMapping = static_cast<uint8_t*>(glMapBufferRange(MAP_TARGET,
+                mFrameIndex * mFrameSize + mMappedFrom,
+                mFrameSize - mMappedFrom,
+                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+            glBindBuffer(MAP_TARGET, 0);
+            if (!mMapping) {
+                throw std::runtime_error("Failed to map streaming buffer");
+            }
+        }
+    }
+
+    void* StreamingBuffer::allocate(uint32_t inSize, uint32_t& outOffset, uint32_t inAlignment) {
+        uint32_t offset = (mHead + inAlignment - 1) / inAlignment * inAlignment;
+        if (offset + inSize > mFrameSize) {
+            return nullptr;
+        }
+
+        mapCurrentRegion();
+        mHead = offset + inSize;
+        outOffset = mFrameIndex * mFrameSize + offset;
+        return mPersistent ? mMapping + outOffset : mMapping + (offset - mMappedFrom);
+    }
+
+    uint32_t StreamingBuffer::write(const void* inData, uint32_t inSize, uint32_t inAlignment) {
+        uint32_t offset = 0;
+        void* destination = allocate(inSize, offset, inAlignment);
+        if (!destination) {
+            throw std::runtime_error("Streaming buffer frame region exhausted");
+        }
+        std::memcpy(destination, inData, inSize);
+        return offset;
+    }
+
+    void StreamingBuffer::flush() {
+        if (mPersistent || !mMapping) {
+            return;
+        }
+
+        glBindBuffer(MAP_TARGET, mBuffer);
+        glFlushMappedBufferRange(MAP_TARGET, 0, mHead - mMappedFrom);
+        glUnmapBuffer(MAP_TARGET);
+        glBindBuffer(MAP_TARGET, 0);
+
+        mMapping = nullptr;
+        mFlushedHead = mHead;
+    }
+
+    void StreamingBuffer::nextFrame() {
+        flush();
+
+        if (mFences[mFrameIndex]) {
+            glDeleteSync(mFences[mFrameIndex]);
+        }
+        mFences[mFrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        mFrameIndex = (mFrameIndex + 1) % FRAME_COUNT;
+        mHead = 0;
+        mFlushedHead = 0;
+
+        if (GLsync fence = mFences[mFrameIndex]) {
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            for (;;) {
+                GLenum result = glClientWaitSync(fence, flags, FENCE_WAIT_NS);
+                if (result != GL_TIMEOUT_EXPIRED) {
+                    break;
+                }
+                flags = 0;
+            }
+            glDeleteSync(fence);
+            mFences[mFrameIndex] = nullptr;
+        }
+    }
+
+    void StreamingBuffer::bindRange(uint32_t inBinding, uint32_t inOffset, uint32_t inSize) const {
+        glBindBufferRange(mTargetType, inBinding, mBuffer, inOffset, inSize);
+    }
+
+    bool StreamingBuffer::isPersistent() const {
+        return mPersistent;
+    }
+
+    uint32_t StreamingBuffer::getFrameSize() const {
+        return mFrameSize;
+    }
+
+    uint32_t StreamingBuffer::getFrameUsage() const {
+        return mHead;
+    }
+
+} // namespace sane::gfx
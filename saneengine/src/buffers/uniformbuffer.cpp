@@ -0,0 +1,40 @@
+#include "saneengine/gfx/buffers/uniformbuffer.hpp"
+#include "saneengine/gfx/buffers/uniformblocks.hpp"
+#include "saneengine/gfx/shaders/shaderreflection.hpp"
+
+namespace sane::gfx {
+
+    UniformBuffer::UniformBuffer(uint32_t inSize, GLenum inUsage, const void* inData)
+        : Buffer(GL_UNIFORM_BUFFER, inSize, inUsage, inData)
+    {
+    }
+
+    void UniformBuffer::bindBase(uint32_t inBinding) const {
+        glBindBufferBase(GL_UNIFORM_BUFFER, inBinding, mBuffer);
+    }
+
+    void UniformBuffer::bindRange(uint32_t inBinding, uint32_t inOffset, uint32_t inSize) const {
+        glBindBufferRange(GL_UNIFORM_BUFFER, inBinding, mBuffer, inOffset, inSize);
+    }
+
+    uint32_t UniformBuffer::getOffsetAlignment() {
+        static const uint32_t sAlignment = [] {
+            GLint alignment = 256;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            return static_cast<uint32_t>(alignment);
+        }();
+        return sAlignment;
+    }
+
+    void bindEngineUniformBlocks(const ShaderReflection& inReflection) {
+        for (const auto& block : inReflection.getUniformBlocks()) {
+            if (block.name == FRAME_UNIFORM_BLOCK) {
+                glUniformBlockBinding(inReflection.getProgramId(), block.index, FRAME_UNIFORM_BINDING);
+            }
+            else if (block.name == OBJECT_UNIFORM_BLOCK) {
+                glUniformBlockBinding(inReflection.getProgramId(), block.index, OBJECT_UNIFORM_BINDING);
+            }
+        }
+    }
+
+} // namespace sane::gfx
@@ -0,0 +1,72 @@
+#include "saneengine/gfx/commands/rendercommandbuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sane::gfx {
+
+    void RenderCommandBuffer::reset() {
+        mCommandHead = 0;
+        mDataHead = 0;
+        mCommandCount = 0;
+    }
+
+    uint32_t RenderCommandBuffer::grow(std::vector<uint8_t>& inStorage, uint32_t& ioHead, uint32_t inSize) {
+        uint32_t offset = ioHead;
+        uint32_t required = offset + (inSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        if (required > inStorage.size()) {
+            // Storage comes from operator new, so offsets stay ALIGNMENT aligned in memory too
+            inStorage.resize(std::max<size_t>(required, inStorage.size() * 2));
+        }
+        ioHead = required;
+        return offset;
+    }
+
+    void* RenderCommandBuffer::allocateCommand(RenderCommandType inType, uint32_t inSize) {
+        uint32_t offset = grow(mCommands, mCommandHead, HEADER_SIZE + inSize);
+        auto* header = new (mCommands.data() + offset) RenderCommandHeader;
+        header->type = inType;
+        header->size = mCommandHead - offset;
+        ++mCommandCount;
+        return mCommands.data() + offset + HEADER_SIZE;
+    }
+
+    void* RenderCommandBuffer::allocateData(uint32_t inSize, uint32_t& outOffset) {
+        outOffset = grow(mData, mDataHead, inSize);
+        return mData.data() + outOffset;
+    }
+
+    uint32_t RenderCommandBuffer::pushData(const void* inData, uint32_t inSize) {
+        uint32_t offset = 0;
+        void* destination = allocateData(inSize, offset);
+        if (inSize) {
+            std::memcpy(destination, inData, inSize);
+        }
+        return offset;
+    }
+
+    const void* RenderCommandBuffer::getData(uint32_t inOffset) const {
+        return mData.data() + inOffset;
+    }
+
+    void RenderCommandBuffer::setTimestamp(std::chrono::steady_clock::time_point inTimestamp) {
+        mTimestamp = inTimestamp;
+    }
+
+    std::chrono::steady_clock::time_point RenderCommandBuffer::getTimestamp() const {
+        return mTimestamp;
+    }
+
+    uint32_t RenderCommandBuffer::getCommandCount() const {
+        return mCommandCount;
+    }
+
+    uint32_t RenderCommandBuffer::getCommandBytes() const {
+        return mCommandHead;
+    }
+
+    uint32_t RenderCommandBuffer::getDataBytes() const {
+        return mDataHead;
+    }
+
+} // namespace sane::gfx
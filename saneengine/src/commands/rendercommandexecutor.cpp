@@ -0,0 +1,422 @@
+#include "saneengine/gfx/commands/rendercommandexecutor.hpp"
+#include "saneengine/ecs/systems/rendersystem.hpp"
+#include "saneengine/gfx/buffers/streamingbuffer.hpp"
+#include "saneengine/gfx/buffers/uniformbuffer.hpp"
+#include "saneengine/gfx/commands/rendercommandbuffer.hpp"
+#include "saneengine/gfx/meshes/mesh.hpp"
+#include "saneengine/gfx/shaders/shaderprogram.hpp"
+#include "saneengine/gfx/shaders/shaderreflection.hpp"
+#include <glad/glad.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // Blends two affine transforms component-wise (translation, rotation and
+    // scale) so rotating instances do not shear or shrink mid-step
+    glm::mat4 interpolateTransform(const glm::mat4& from, const glm::mat4& to, float alpha) {
+        glm::vec3 fromScale(glm::length(glm::vec3(from[0])), glm::length(glm::vec3(from[1])), glm::length(glm::vec3(from[2])));
+        glm::vec3 toScale(glm::length(glm::vec3(to[0])), glm::length(glm::vec3(to[1])), glm::length(glm::vec3(to[2])));
+        if (fromScale.x == 0.0f || fromScale.y == 0.0f || fromScale.z == 0.0f
+            || toScale.x == 0.0f || toScale.y == 0.0f || toScale.z == 0.0f) {
+            return alpha < 0.5f ? from : to;
+        }
+
+        glm::mat3 fromBasis(glm::vec3(from[0]) / fromScale.x, glm::vec3(from[1]) / fromScale.y, glm::vec3(from[2]) / fromScale.z);
+        glm::mat3 toBasis(glm::vec3(to[0]) / toScale.x, glm::vec3(to[1]) / toScale.y, glm::vec3(to[2]) / toScale.z);
+        glm::mat3 basis = glm::mat3_cast(glm::slerp(glm::quat_cast(fromBasis), glm::quat_cast(toBasis), alpha));
+        glm::vec3 scale = glm::mix(fromScale, toScale, alpha);
+
+        glm::mat4 result(1.0f);
+        result[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+        result[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+        result[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+        result[3] = glm::mix(from[3], to[3], alpha);
+        return result;
+    }
+}
+
+namespace sane::gfx {
+    class RenderCommandExecutor::Impl {
+    public:
+        // Reflected once per program id, the draw loop only reads resolved locations
+        struct ProgramInfo {
+            explicit ProgramInfo(uint32_t programId)
+                : serial(getOwnerSerial(programId))
+                , reflection(programId)
+                , instanceModelLocation(reflection.getAttribLocation(ecs::RenderSystem::INSTANCE_MODEL_ATTRIBUTE))
+                , modelUniform(reflection.getUniformHandle("model"))
+                , usesObjectBlock(reflection.findUniformBlock(OBJECT_UNIFORM_BLOCK) != nullptr)
+            {
+                bindEngineUniformBlocks(reflection);
+            }
+
+            bool isInstanced() const { return instanceModelLocation >= 0; }
+
+            // 0 for programs made outside ShaderProgram
+            static uint64_t getOwnerSerial(uint32_t programId) {
+                const auto* owner = ShaderProgram::find(programId);
+                return owner ? owner->getSerial() : 0;
+            }
+
+            // False once the program was deleted, or its id handed to a new one
+            bool isCurrent(uint32_t programId) const {
+                auto current = getOwnerSerial(programId);
+                return current == serial && (current != 0 || glIsProgram(programId));
+            }
+
+            uint64_t serial;
+            ShaderReflection reflection;
+            int32_t instanceModelLocation;
+            // Slots match the owning ShaderProgram's, both reflect the same program
+            UniformHandle modelUniform;
+            bool usesObjectBlock;
+        };
+
+        std::unordered_map<uint64_t, std::unique_ptr<Mesh>> meshes;
+        std::unordered_map<uint32_t, ProgramInfo> programs;
+
+        std::unique_ptr<UniformBuffer> frameBuffer;
+        FrameUniforms frameUniforms;
+
+        // The two most recent snapshots, entity ids parallel to the matrices
+        std::vector<glm::mat4> currentInstances;
+        std::vector<uint32_t> currentEntities;
+        std::vector<glm::mat4> previousInstances;
+        std::vector<uint32_t> previousEntities;
+        std::unordered_map<uint32_t, uint32_t> previousLookup;
+        bool previousLookupValid{ false };
+        std::vector<glm::mat4> blendedInstances;
+        std::vector<DrawBatchCommand> draws;
+        std::chrono::steady_clock::time_point snapshotTime;
+        bool snapshot{ false };
+
+        // Instance matrices and object blocks are written straight into mapped
+        // per-frame regions, so uploads never wait on draws still in flight
+        std::unique_ptr<StreamingBuffer> instanceBuffer;
+        uint32_t instanceOffset{ 0 };
+        const glm::mat4* instances{ nullptr };
+
+        std::unique_ptr<StreamingBuffer> objectBuffer;
+        uint32_t objectStride{ 0 };
+        uint32_t objectOffset{ 0 };
+
+        // State bound during the draw loop, so consecutive batches sharing it skip the call
+        uint32_t boundProgram{ 0 };
+        GLuint boundVertexArray{ 0 };
+        GLuint boundArrayBuffer{ 0 };
+
+        // Instance attribute location enabled with a divisor in each mesh's vertex array
+        std::unordered_map<uint64_t, int32_t> instancedLocations;
+
+        // Programs belong to whoever created them and may go away between frames
+        void evictStalePrograms() {
+            for (auto it = programs.begin(); it != programs.end();) {
+                it = it->second.isCurrent(it->first) ? std::next(it) : programs.erase(it);
+            }
+        }
+
+        const ProgramInfo& getProgramInfo(uint32_t programId) {
+            auto it = programs.find(programId);
+            if (it == programs.end()) {
+                it = programs.try_emplace(programId, programId).first;
+            }
+            return it->second;
+        }
+
+        void uploadFrameUniforms() {
+            GLint viewport[4] = { 0, 0, 0, 0 };
+            glGetIntegerv(GL_VIEWPORT, viewport);
+
+            FrameUniforms uniforms = frameUniforms;
+            uniforms.viewport = glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+            if (!frameBuffer) {
+                frameBuffer = std::make_unique<UniformBuffer>(static_cast<uint32_t>(sizeof(FrameUniforms)));
+            }
+            frameBuffer->update(sizeof(FrameUniforms), 0, &uniforms);
+            frameBuffer->bindBase(FRAME_UNIFORM_BINDING);
+        }
+
+        void uploadMesh(const RenderCommandBuffer& commands, const UploadMeshCommand& command) {
+            const auto* vertices = static_cast<const float*>(commands.getData(command.vertexDataOffset));
+            const auto* first = static_cast<const VertexAttribute*>(commands.getData(command.attributeDataOffset));
+            std::vector<VertexAttribute> attributes(first, first + command.attributeCount);
+
+            meshes[command.meshId] = std::make_unique<Mesh>(vertices, command.vertexCount, attributes);
+            instancedLocations.erase(command.meshId);
+        }
+
+        void releaseMesh(uint64_t meshId) {
+            meshes.erase(meshId);
+            instancedLocations.erase(meshId);
+        }
+
+        // Recreates a streaming buffer when a frame needs more than one region holds
+        static void reserveStream(std::unique_ptr<StreamingBuffer>& buffer, GLenum target, uint32_t required) {
+            if (buffer && required <= buffer->getFrameSize()) return;
+
+            uint32_t frameSize = buffer ? std::max(required, buffer->getFrameSize() * 2) : required;
+            buffer = std::make_unique<StreamingBuffer>(target, frameSize);
+        }
+
+        void storeInstances(const RenderCommandBuffer& commands, const SubmitInstancesCommand& command) {
+            const auto* matrices = static_cast<const glm::mat4*>(commands.getData(command.dataOffset));
+            const auto* entities = static_cast<const uint32_t*>(commands.getData(command.entityDataOffset));
+            currentInstances.assign(matrices, matrices + command.instanceCount);
+            currentEntities.assign(entities, entities + command.instanceCount);
+        }
+
+        void beginSnapshot() {
+            previousInstances.swap(currentInstances);
+            previousEntities.swap(currentEntities);
+            currentInstances.clear();
+            currentEntities.clear();
+            draws.clear();
+            previousLookupValid = false;
+        }
+
+        const glm::mat4* interpolate(float alpha) {
+            if (alpha >= 1.0f || previousEntities.empty()) {
+                return currentInstances.data();
+            }
+
+            // Built on first use, variable rate frames never pay for it
+            if (!previousLookupValid) {
+                previousLookup.clear();
+                for (uint32_t i = 0; i < previousEntities.size(); ++i) {
+                    previousLookup.emplace(previousEntities[i], i);
+                }
+                previousLookupValid = true;
+            }
+
+            blendedInstances.resize(currentInstances.size());
+            for (size_t i = 0; i < currentInstances.size(); ++i) {
+                const auto& current = currentInstances[i];
+                auto it = previousLookup.find(currentEntities[i]);
+                if (it == previousLookup.end()) {
+                    // Spawned this step, nothing to blend from
+                    blendedInstances[i] = current;
+                    continue;
+                }
+
+                const auto& previous = previousInstances[it->second];
+                blendedInstances[i] = std::memcmp(&previous, &current, sizeof(glm::mat4)) == 0
+                    ? current
+                    : interpolateTransform(previous, current, alpha);
+            }
+            return blendedInstances.data();
+        }
+
+        void streamInstances() {
+            auto instanceCount = static_cast<uint32_t>(currentInstances.size());
+            if (!instanceCount) return;
+
+            auto required = instanceCount * static_cast<uint32_t>(sizeof(glm::mat4));
+            reserveStream(instanceBuffer, GL_ARRAY_BUFFER, required);
+            std::memcpy(instanceBuffer->allocate(required, instanceOffset), instances, required);
+        }
+
+        void streamObjects() {
+            uint32_t objectCount = 0;
+            for (const auto& draw : draws) {
+                const auto& program = getProgramInfo(draw.programId);
+                if (!program.isInstanced() && program.usesObjectBlock) {
+                    objectCount += draw.instanceCount;
+                }
+            }
+            if (!objectCount) return;
+
+            if (!objectStride) {
+                auto alignment = UniformBuffer::getOffsetAlignment();
+                objectStride = (static_cast<uint32_t>(sizeof(ObjectUniforms)) + alignment - 1) / alignment * alignment;
+            }
+
+            auto required = objectCount * objectStride;
+            reserveStream(objectBuffer, GL_UNIFORM_BUFFER, required);
+
+            auto* destination = static_cast<uint8_t*>(
+                objectBuffer->allocate(required, objectOffset, UniformBuffer::getOffsetAlignment()));
+            for (const auto& draw : draws) {
+                const auto& program = getProgramInfo(draw.programId);
+                if (program.isInstanced() || !program.usesObjectBlock) continue;
+
+                for (uint32_t i = 0; i < draw.instanceCount; ++i) {
+                    ObjectUniforms object{ instances[draw.firstInstance + i] };
+                    std::memcpy(destination, &object, sizeof(object));
+                    destination += objectStride;
+                }
+            }
+        }
+
+        // Enabling and divisors are vertex array state and only set once per mesh.
+        // Pointers still move per batch, GL 3.3 has no base instance.
+        void bindInstanceAttributes(uint64_t meshId, uint32_t location, size_t firstInstance, SubmitStats& stats) {
+            if (boundArrayBuffer != instanceBuffer->getBufferId()) {
+                instanceBuffer->bind();
+                boundArrayBuffer = instanceBuffer->getBufferId();
+                ++stats.bufferBinds;
+            }
+
+            auto [it, inserted] = instancedLocations.try_emplace(meshId, static_cast<int32_t>(location));
+            bool configure = inserted || it->second != static_cast<int32_t>(location);
+            if (configure && !inserted) {
+                disableInstanceAttributes(static_cast<uint32_t>(it->second));
+            }
+            it->second = static_cast<int32_t>(location);
+
+            for (uint32_t column = 0; column < 4; ++column) {
+                if (configure) {
+                    glEnableVertexAttribArray(location + column);
+                    glVertexAttribDivisor(location + column, 1);
+                }
+                glVertexAttribPointer(
+                    location + column,
+                    4,
+                    GL_FLOAT,
+                    GL_FALSE,
+                    sizeof(glm::mat4),
+                    (void*)(instanceOffset + firstInstance * sizeof(glm::mat4) + column * sizeof(glm::vec4))
+                );
+            }
+        }
+
+        void disableInstanceAttributes(uint32_t location) {
+            for (uint32_t column = 0; column < 4; ++column) {
+                glVertexAttribDivisor(location + column, 0);
+                glDisableVertexAttribArray(location + column);
+            }
+        }
+
+        void draw(const DrawBatchCommand& batch, SubmitStats& stats) {
+            auto it = meshes.find(batch.meshId);
+            if (it == meshes.end() || batch.firstInstance + batch.instanceCount > currentInstances.size()) return;
+
+            const auto& program = getProgramInfo(batch.programId);
+            const auto& mesh = *it->second;
+            auto vertexCount = static_cast<GLsizei>(mesh.getVertexCount());
+
+            if (boundVertexArray != mesh.getVertexArray()) {
+                mesh.bind();
+                boundVertexArray = mesh.getVertexArray();
+                ++stats.vertexArrayBinds;
+            }
+            if (boundProgram != batch.programId) {
+                ShaderProgram::use(batch.programId);
+                boundProgram = batch.programId;
+                ++stats.programBinds;
+            }
+
+            if (program.isInstanced()) {
+                auto location = static_cast<uint32_t>(program.instanceModelLocation);
+                bindInstanceAttributes(batch.meshId, location, batch.firstInstance, stats);
+                glDrawArraysInstanced(GL_TRIANGLES, 0, vertexCount, static_cast<GLsizei>(batch.instanceCount));
+                ++stats.drawCalls;
+            }
+            else if (program.usesObjectBlock) {
+                for (uint32_t i = 0; i < batch.instanceCount; ++i) {
+                    objectBuffer->bindRange(OBJECT_UNIFORM_BINDING, objectOffset,
+                        static_cast<uint32_t>(sizeof(ObjectUniforms)));
+                    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+                    objectOffset += objectStride;
+                    ++stats.drawCalls;
+                }
+            }
+            else {
+                // Through the owner's value cache when there is one, so it never goes stale
+                auto* owner = ShaderProgram::find(batch.programId);
+                for (uint32_t i = 0; i < batch.instanceCount; ++i) {
+                    const auto& model = instances[batch.firstInstance + i];
+                    if (owner) {
+                        owner->setUniform(program.modelUniform, model);
+                    }
+                    else {
+                        glUniformMatrix4fv(program.modelUniform.location, 1, GL_FALSE, glm::value_ptr(model));
+                    }
+                    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+                    ++stats.drawCalls;
+                }
+            }
+            stats.instances += batch.instanceCount;
+        }
+    };
+
+    RenderCommandExecutor::RenderCommandExecutor()
+        : mImpl(new Impl)
+    {
+    }
+
+    RenderCommandExecutor::~RenderCommandExecutor() {
+        delete mImpl;
+    }
+
+    void RenderCommandExecutor::apply(const RenderCommandBuffer& commands) {
+        mImpl->beginSnapshot();
+
+        commands.forEach([this, &commands](const RenderCommandHeader& header, const void* payload) {
+            switch (header.type) {
+            case RenderCommandType::SetFrame:
+                mImpl->frameUniforms = static_cast<const SetFrameCommand*>(payload)->uniforms;
+                break;
+            case RenderCommandType::UploadMesh:
+                mImpl->uploadMesh(commands, *static_cast<const UploadMeshCommand*>(payload));
+                break;
+            case RenderCommandType::ReleaseMesh:
+                mImpl->releaseMesh(static_cast<const ReleaseMeshCommand*>(payload)->meshId);
+                break;
+            case RenderCommandType::SubmitInstances:
+                mImpl->storeInstances(commands, *static_cast<const SubmitInstancesCommand*>(payload));
+                break;
+            case RenderCommandType::DrawBatch:
+                mImpl->draws.push_back(*static_cast<const DrawBatchCommand*>(payload));
+                break;
+            }
+        });
+
+        mImpl->snapshotTime = commands.getTimestamp();
+        mImpl->snapshot = true;
+    }
+
+    SubmitStats RenderCommandExecutor::draw(float alpha) {
+        SubmitStats stats;
+        if (!mImpl->snapshot) return stats;
+
+        mImpl->uploadFrameUniforms();
+        mImpl->evictStalePrograms();
+
+        // Every instance matrix and object block of the frame is streamed with one mapping each
+        mImpl->instances = mImpl->interpolate(alpha);
+        mImpl->streamInstances();
+        mImpl->streamObjects();
+        if (mImpl->instanceBuffer) mImpl->instanceBuffer->flush();
+        if (mImpl->objectBuffer) mImpl->objectBuffer->flush();
+
+        // Layers and uploads may have bound anything since the last frame
+        mImpl->boundProgram = 0;
+        mImpl->boundVertexArray = 0;
+        mImpl->boundArrayBuffer = 0;
+        for (const auto& draw : mImpl->draws) {
+            mImpl->draw(draw, stats);
+        }
+        glBindVertexArray(0);
+
+        // Fence this frame's regions; the next write lands in a region the GPU is done with
+        if (mImpl->instanceBuffer) mImpl->instanceBuffer->nextFrame();
+        if (mImpl->objectBuffer) mImpl->objectBuffer->nextFrame();
+
+        return stats;
+    }
+
+    bool RenderCommandExecutor::hasSnapshot() const {
+        return mImpl->snapshot;
+    }
+
+    std::chrono::steady_clock::time_point RenderCommandExecutor::getSnapshotTime() const {
+        return mImpl->snapshotTime;
+    }
+}
@@ -0,0 +1,78 @@
+#include "saneengine/gfx/commands/rendercommandqueue.hpp"
+
+namespace sane::gfx {
+
+    RenderCommandBuffer* RenderCommandQueue::beginRecording() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this] {
+            return mShutdown || mStates[mRecordIndex] == SlotState::Free;
+        });
+        if (mShutdown) {
+            return nullptr;
+        }
+
+        mStates[mRecordIndex] = SlotState::Recording;
+        auto& buffer = mBuffers[mRecordIndex];
+        buffer.reset();
+        return &buffer;
+    }
+
+    RenderCommandBuffer* RenderCommandQueue::getRecordingBuffer() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStates[mRecordIndex] == SlotState::Recording ? &mBuffers[mRecordIndex] : nullptr;
+    }
+
+    void RenderCommandQueue::submit() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStates[mRecordIndex] != SlotState::Recording) {
+                return;
+            }
+            mStates[mRecordIndex] = SlotState::Submitted;
+            mRecordIndex = (mRecordIndex + 1) % BUFFER_COUNT;
+        }
+        mCondition.notify_all();
+    }
+
+    const RenderCommandBuffer* RenderCommandQueue::acquire(bool inWait) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (inWait) {
+            mCondition.wait(lock, [this] {
+                return mShutdown || mStates[mRenderIndex] == SlotState::Submitted;
+            });
+        }
+        if (mShutdown || mStates[mRenderIndex] != SlotState::Submitted) {
+            return nullptr;
+        }
+
+        mStates[mRenderIndex] = SlotState::Rendering;
+        return &mBuffers[mRenderIndex];
+    }
+
+    void RenderCommandQueue::release(const SubmitStats& inStats) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStates[mRenderIndex] != SlotState::Rendering) {
+                return;
+            }
+            mStates[mRenderIndex] = SlotState::Free;
+            mRenderIndex = (mRenderIndex + 1) % BUFFER_COUNT;
+            mLastStats = inStats;
+        }
+        mCondition.notify_all();
+    }
+
+    SubmitStats RenderCommandQueue::getLastSubmitStats() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mLastStats;
+    }
+
+    void RenderCommandQueue::shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mShutdown = true;
+        }
+        mCondition.notify_all();
+    }
+
+} // namespace sane::gfx
@@ -0,0 +1,125 @@
+#include "saneengine/ecs/commandbuffer.hpp"
+#include "saneengine/utils/framearena.hpp"
+#include <algorithm>
+#include <memory_resource>
+
+namespace sane::ecs {
+    class CommandBuffer::Impl {
+    public:
+        uint32_t createCount{ 0 };
+        // Entities created on playback, indexed by Created::index
+        std::vector<entt::entity> created;
+        std::vector<Target> destroys;
+        // In order of first use, kept across frames so their vectors keep capacity
+        std::vector<std::pair<entt::id_type, std::unique_ptr<Queue>>> queues;
+        size_t commandCount{ 0 };
+    };
+
+    CommandBuffer::CommandBuffer() : mImpl(new Impl) {}
+
+    CommandBuffer::~CommandBuffer() {
+        delete mImpl;
+    }
+
+    CommandBuffer::Created CommandBuffer::create() {
+        ++mImpl->commandCount;
+        return { mImpl->createCount++ };
+    }
+
+    void CommandBuffer::destroy(Target target) {
+        ++mImpl->commandCount;
+        mImpl->destroys.push_back(target);
+    }
+
+    bool CommandBuffer::empty() const {
+        return mImpl->commandCount == 0;
+    }
+
+    void CommandBuffer::clear() {
+        mImpl->createCount = 0;
+        mImpl->created.clear();
+        mImpl->destroys.clear();
+        for (auto& [type, queue] : mImpl->queues) {
+            queue->clear();
+        }
+        mImpl->commandCount = 0;
+    }
+
+    CommandBuffer::Queue& CommandBuffer::getQueue(entt::id_type type, std::unique_ptr<Queue>(*create)()) {
+        ++mImpl->commandCount;
+        for (auto& [queueType, queue] : mImpl->queues) {
+            if (queueType == type) {
+                return *queue;
+            }
+        }
+        return *mImpl->queues.emplace_back(type, create()).second;
+    }
+
+    void CommandBuffer::playback(entt::registry& registry) {
+        CommandBuffer* self = this;
+        playback(registry, { &self, 1 });
+    }
+
+    void CommandBuffer::playback(entt::registry& registry, std::span<CommandBuffer* const> buffers) {
+        auto& arena = utils::FrameArena::get();
+
+        // Entities first, one range per buffer
+        for (auto* buffer : buffers) {
+            auto& impl = *buffer->mImpl;
+            impl.created.resize(impl.createCount);
+            registry.create(impl.created.begin(), impl.created.end());
+        }
+
+        // Component commands grouped by type, so every pool is grown once and
+        // walked in one go. Types keep the order they first appear in.
+        struct Group {
+            entt::id_type type;
+            std::pmr::vector<std::pair<Queue*, const Impl*>> queues;
+        };
+        std::pmr::vector<Group> groups(&arena);
+        for (auto* buffer : buffers) {
+            for (auto& [type, queue] : buffer->mImpl->queues) {
+                auto group = std::find_if(groups.begin(), groups.end(), [type = type](const Group& group) {
+                    return group.type == type;
+                });
+                if (group == groups.end()) {
+                    groups.push_back({ type, std::pmr::vector<std::pair<Queue*, const Impl*>>(&arena) });
+                    group = groups.end() - 1;
+                }
+                group->queues.emplace_back(queue.get(), buffer->mImpl);
+            }
+        }
+
+        for (auto& group : groups) {
+            size_t emplaces = 0;
+            for (auto [queue, impl] : group.queues) {
+                emplaces += queue->getEmplaceCount();
+            }
+            if (emplaces > 0) {
+                group.queues.front().first->reserve(registry, emplaces);
+            }
+            for (auto [queue, impl] : group.queues) {
+                queue->play(registry, impl->created);
+            }
+        }
+
+        // Destroys last, sorted so each entity goes once and in the same order every run
+        std::pmr::vector<entt::entity> destroyed(&arena);
+        for (auto* buffer : buffers) {
+            const auto& impl = *buffer->mImpl;
+            for (const auto& target : impl.destroys) {
+                destroyed.push_back(target.created ? impl.created[target.created - 1] : target.entity);
+            }
+        }
+        std::sort(destroyed.begin(), destroyed.end());
+        destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+        destroyed.erase(std::remove_if(destroyed.begin(), destroyed.end(), [&registry](entt::entity entity) {
+            return !registry.valid(entity);
+        }), destroyed.end());
+        registry.destroy(destroyed.begin(), destroyed.end());
+
+        for (auto* buffer : buffers) {
+            buffer->clear();
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#include "saneengine/ecs/components/bounds.hpp"
+#include "saneengine/ecs/components/vertex.hpp"
+
+namespace sane::ecs {
+    BoundsComponent BoundsComponent::fromVertices(const VertexComponent& vertex) {
+        BoundsComponent bounds;
+        const auto& mesh = vertex.getMesh();
+        if (!mesh || mesh->vertexCount == 0) return bounds;
+
+        // Computed once by the MeshRegistry for every entity sharing the mesh
+        bounds.min = mesh->boundsMin;
+        bounds.max = mesh->boundsMax;
+        return bounds;
+    }
+}
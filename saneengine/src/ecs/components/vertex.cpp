@@ -1,48 +1,42 @@
 #include "saneengine/ecs/components/vertex.hpp"
-#include <cstring>
+#include <utility>
 
 namespace sane::ecs {
-    VertexComponent::VertexComponent() = default;
-
-    VertexComponent::~VertexComponent() {
-        delete[] vertices;
+    VertexComponent::VertexComponent(gfx::MeshHandle inMesh) : mesh(std::move(inMesh)), initialized(static_cast<bool>(mesh)) {
     }
 
-    VertexComponent::VertexComponent(const VertexComponent& other) {
-        if (other.vertices && other.vertexCount > 0) {
-            vertices = new float[other.vertexCount];
-            std::memcpy(vertices, other.vertices, other.vertexCount * sizeof(float));
-            vertexCount = other.vertexCount;
-        }
+    void VertexComponent::setVertexData(const float* data, size_t count) {
+        mesh = gfx::MeshRegistry::get().acquire(data, count, getAttributes());
+        setInitialized(true);
     }
 
-    VertexComponent& VertexComponent::operator=(const VertexComponent& other) {
-        if (this != &other) {
-            delete[] vertices;
-            if (other.vertices && other.vertexCount > 0) {
-                vertices = new float[other.vertexCount];
-                std::memcpy(vertices, other.vertices, other.vertexCount * sizeof(float));
-                vertexCount = other.vertexCount;
-            }
-        }
-        return *this;
+    void VertexComponent::setVertexData(std::initializer_list<float> data, size_t count) {
+        setVertexData(data.begin(), count);
     }
 
-    void VertexComponent::setVertexData(const float* data, size_t count) {
-        delete[] vertices;
-        vertices = new float[count * 3];
-        vertexCount = count;
-        std::memcpy(vertices, data, 3 * count * sizeof(float));
+    void VertexComponent::setMesh(gfx::MeshHandle inMesh) {
+        mesh = std::move(inMesh);
+        setInitialized(static_cast<bool>(mesh));
+    }
 
-        setInitialized(true);
+    const float* VertexComponent::getVertices() const {
+        return mesh && mesh->vertexCount > 0 ? mesh->vertices.data() : nullptr;
     }
 
-    void VertexComponent::setVertexData(std::initializer_list<float> data, size_t count) {
-        setVertexData(data.begin(), count);
+    size_t VertexComponent::getVertexCount() const {
+        return mesh ? mesh->vertexCount : 0;
     }
 
-    const float* VertexComponent::getVertices() const { return vertices; }
-    size_t VertexComponent::getVertexCount() const { return vertexCount; }
     bool VertexComponent::isInitialized() const { return initialized; }
     void VertexComponent::setInitialized(bool value) { initialized = value; }
-}
\ No newline at end of file
+
+    void VertexComponent::setAttributes(const std::vector<gfx::VertexAttribute>& attrs) {
+        // Attributes are part of the shared mesh, so changing them picks another one
+        mesh = gfx::MeshRegistry::get().acquire(getVertices(), getVertexCount(), attrs);
+    }
+
+    const std::vector<gfx::VertexAttribute>& VertexComponent::getAttributes() const {
+        static const std::vector<gfx::VertexAttribute> none;
+        return mesh ? mesh->attributes : none;
+    }
+}
@@ -1,21 +1,41 @@
 #include "saneengine/ecs/system.hpp"
 #include <string>
+#include <vector>
 
 namespace sane::ecs {
     class System::Impl {
     public:
+        struct Access {
+            entt::id_type type;
+            bool write;
+            // nullptr for a context value, which has no storage
+            void (*create)(entt::registry&);
+
+            bool sameTarget(const Access& other) const {
+                return type == other.type && (create == nullptr) == (other.create == nullptr);
+            }
+        };
+
         std::string name;
         bool enabled{ true };
         int32_t priority{ 0 };
         utils::UUID id{ 0 };
+        std::vector<Access> access;
+        bool exclusive{ false };
+        CommandBuffer commands;
+        std::shared_ptr<utils::TimingTrack> timing;
     };
 
     System::System(const char* name, int32_t priority) : mImpl(new Impl) {
         mImpl->name = name;
         mImpl->priority = priority;
+        mImpl->timing = utils::Timings::get().addTrack(name, utils::TimingKind::System);
     }
 
     System::~System() {
+        if (mImpl->timing) {
+            utils::Timings::get().removeTrack(mImpl->timing.get());
+        }
         delete mImpl;
     }
 
@@ -42,4 +62,54 @@ namespace sane::ecs {
     void System::setId(utils::UUID id) {
         mImpl->id = id;
     }
+
+    bool System::conflictsWith(const System& other) const {
+        if (isExclusive() || other.isExclusive()) {
+            return true;
+        }
+
+        for (const auto& mine : mImpl->access) {
+            for (const auto& theirs : other.mImpl->access) {
+                if (mine.sameTarget(theirs) && (mine.write || theirs.write)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool System::isExclusive() const {
+        return mImpl->exclusive || mImpl->access.empty();
+    }
+
+    CommandBuffer& System::getCommands() {
+        return mImpl->commands;
+    }
+
+    utils::TimingTrack* System::getTiming() const {
+        return mImpl->timing.get();
+    }
+
+    void System::prepareStorage(entt::registry& registry) const {
+        for (const auto& access : mImpl->access) {
+            if (access.create) {
+                access.create(registry);
+            }
+        }
+    }
+
+    void System::declareExclusive() {
+        mImpl->exclusive = true;
+    }
+
+    void System::addAccess(entt::id_type type, bool write, void (*create)(entt::registry&)) {
+        Impl::Access added{ type, write, create };
+        for (auto& access : mImpl->access) {
+            if (access.sameTarget(added)) {
+                access.write = access.write || write;
+                return;
+            }
+        }
+        mImpl->access.push_back(added);
+    }
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include "saneengine/ecs/systemmanager.hpp"
 #include "saneengine/ecs/system.hpp"
+#include "saneengine/jobs/jobsystem.hpp"
+#include "saneengine/utils/framearena.hpp"
+#include "saneengine/utils/profiler.hpp"
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 
 namespace sane::ecs {
@@ -9,6 +15,107 @@ namespace sane::ecs {
     public:
         std::vector<std::unique_ptr<System>> systems;
         std::unique_ptr<entt::registry> registry{ std::make_unique<entt::registry>() };
+
+        // Dependency graph over systems, in priority order. A system waits for
+        // every earlier system it conflicts with, so conflicting systems keep
+        // their priority order and the rest may overlap.
+        std::vector<std::vector<uint32_t>> successors;
+        std::vector<uint32_t> predecessorCounts;
+        // Every system depends on the one before it, nothing can overlap
+        bool serial{ true };
+
+        // State of the update in flight: predecessors still running per system
+        std::unique_ptr<std::atomic<uint32_t>[]> pending;
+        std::atomic<bool> failed{ false };
+
+        void rebuildSchedule() {
+            size_t count = systems.size();
+            successors.assign(count, {});
+            predecessorCounts.assign(count, 0);
+            pending.reset(new std::atomic<uint32_t>[count]);
+            serial = true;
+
+            for (size_t later = 0; later < count; ++later) {
+                systems[later]->prepareStorage(*registry);
+                for (size_t earlier = 0; earlier < later; ++earlier) {
+                    if (systems[earlier]->conflictsWith(*systems[later])) {
+                        successors[earlier].push_back(static_cast<uint32_t>(later));
+                        ++predecessorCounts[later];
+                    }
+                    else if (earlier + 1 == later) {
+                        serial = false;
+                    }
+                }
+            }
+        }
+
+        void updateSerial(float deltaTime) {
+            for (auto& system : systems) {
+                if (system->isEnabled()) {
+                    utils::ScopedTiming timing(system->getTiming());
+                    system->onUpdate(*registry, deltaTime);
+                }
+            }
+        }
+
+        void updateParallel(jobs::JobSystem& jobSystem, float deltaTime) {
+            failed.store(false, std::memory_order_relaxed);
+            for (size_t i = 0; i < systems.size(); ++i) {
+                pending[i].store(predecessorCounts[i], std::memory_order_relaxed);
+            }
+
+            // The calling thread pops its own jobs newest first, so queue the
+            // highest priority last
+            jobs::JobCounter counter;
+            for (size_t i = systems.size(); i-- > 0;) {
+                if (predecessorCounts[i] == 0) {
+                    startSystem(jobSystem, counter, static_cast<uint32_t>(i), deltaTime);
+                }
+            }
+            jobSystem.wait(counter);
+        }
+
+        // Sync point after the update: every system's structural changes, in priority order
+        void playbackCommands() {
+            SANE_PROFILE_SCOPE("SystemManager::playbackCommands");
+            std::pmr::vector<CommandBuffer*> buffers(&utils::FrameArena::get());
+            for (auto& system : systems) {
+                if (!system->getCommands().empty()) {
+                    buffers.push_back(&system->getCommands());
+                }
+            }
+            if (!buffers.empty()) {
+                CommandBuffer::playback(*registry, buffers);
+            }
+        }
+
+        void startSystem(jobs::JobSystem& jobSystem, jobs::JobCounter& counter, uint32_t index, float deltaTime) {
+            jobSystem.run([this, &jobSystem, &counter, index, deltaTime] {
+                runSystem(jobSystem, counter, index, deltaTime);
+            }, &counter);
+        }
+
+        // Runs one system, then starts every successor it was the last predecessor of.
+        // After a failure the remaining systems are skipped and the counter rethrows it.
+        void runSystem(jobs::JobSystem& jobSystem, jobs::JobCounter& counter, uint32_t index, float deltaTime) {
+            auto& system = *systems[index];
+            if (!failed.load(std::memory_order_relaxed) && system.isEnabled()) {
+                try {
+                    utils::ScopedTiming timing(system.getTiming());
+                    system.onUpdate(*registry, deltaTime);
+                }
+                catch (...) {
+                    failed.store(true, std::memory_order_relaxed);
+                    throw;
+                }
+            }
+
+            for (auto successor : successors[index]) {
+                if (pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    startSystem(jobSystem, counter, successor, deltaTime);
+                }
+            }
+        }
     };
 
     SystemManager::SystemManager() : mImpl(new Impl) {}
@@ -31,6 +138,7 @@ namespace sane::ecs {
             });
 
         mImpl->systems.insert(insertPos, std::move(system));
+        mImpl->rebuildSchedule();
     }
 
     void SystemManager::removeSystem(utils::UUID systemId) {
@@ -42,6 +150,7 @@ namespace sane::ecs {
         if (it != mImpl->systems.end()) {
             (*it)->onDetach(*mImpl->registry);
             mImpl->systems.erase(it);
+            mImpl->rebuildSchedule();
         }
     }
 
@@ -55,11 +164,15 @@ namespace sane::ecs {
     }
 
     void SystemManager::update(float deltaTime) {
-        for (auto& system : mImpl->systems) {
-            if (system->isEnabled()) {
-                system->onUpdate(*mImpl->registry, deltaTime);
-            }
+        SANE_PROFILE_SCOPE("SystemManager::update");
+        auto* jobSystem = jobs::JobSystem::get();
+        if (mImpl->serial || !jobSystem || jobSystem->getWorkerCount() == 0) {
+            mImpl->updateSerial(deltaTime);
+        }
+        else {
+            mImpl->updateParallel(*jobSystem, deltaTime);
         }
+        mImpl->playbackCommands();
     }
 
     entt::registry& SystemManager::getRegistry() {
@@ -78,5 +191,6 @@ namespace sane::ecs {
             system->onDetach(*mImpl->registry);
         }
         mImpl->systems.clear();
+        mImpl->rebuildSchedule();
     }
 }
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "saneengine/ecs/systems/hierarchysystem.hpp"
+#include "saneengine/ecs/components/hierarchy.hpp"
+#include "saneengine/ecs/components/transform.hpp"
+#include "saneengine/ecs/transformpass.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    using sane::ecs::HierarchyComponent;
+    using sane::ecs::TransformComponent;
+
+    // Through patch, so the change is observed like any other
+    void markDirty(entt::registry& registry, entt::entity entity) {
+        if (registry.all_of<TransformComponent>(entity)) {
+            registry.patch<TransformComponent>(entity);
+        }
+    }
+
+    // Recomputes depths below root, which must already hold its own depth
+    void updateDepths(entt::registry& registry, entt::entity root) {
+        std::vector<entt::entity> stack{ root };
+        while (!stack.empty()) {
+            auto entity = stack.back();
+            stack.pop_back();
+
+            const auto& node = registry.get<HierarchyComponent>(entity);
+            for (auto child = node.firstChild; child != entt::null;) {
+                auto& childNode = registry.get<HierarchyComponent>(child);
+                childNode.depth = node.depth + 1;
+                stack.push_back(child);
+                child = childNode.nextSibling;
+            }
+        }
+    }
+
+    void unlink(entt::registry& registry, entt::entity entity, HierarchyComponent& node) {
+        if (node.parent == entt::null) return;
+
+        if (node.prevSibling != entt::null) {
+            registry.get<HierarchyComponent>(node.prevSibling).nextSibling = node.nextSibling;
+        }
+        else {
+            registry.get<HierarchyComponent>(node.parent).firstChild = node.nextSibling;
+        }
+
+        if (node.nextSibling != entt::null) {
+            registry.get<HierarchyComponent>(node.nextSibling).prevSibling = node.prevSibling;
+        }
+
+        node.parent = entt::null;
+        node.prevSibling = entt::null;
+        node.nextSibling = entt::null;
+    }
+
+    // Children of a destroyed node become roots
+    void onHierarchyDestroyed(entt::registry& registry, entt::entity entity) {
+        auto& node = registry.get<HierarchyComponent>(entity);
+        unlink(registry, entity, node);
+
+        for (auto child = node.firstChild; child != entt::null;) {
+            auto& childNode = registry.get<HierarchyComponent>(child);
+            auto next = childNode.nextSibling;
+
+            childNode.parent = entt::null;
+            childNode.prevSibling = entt::null;
+            childNode.nextSibling = entt::null;
+            childNode.depth = 0;
+            updateDepths(registry, child);
+            markDirty(registry, child);
+
+            child = next;
+        }
+        node.firstChild = entt::null;
+    }
+}
+
+namespace sane::ecs {
+    class HierarchySystem::Impl {
+    public:
+        TransformPass transformPass;
+        // Transforms emplaced, patched or replaced since the last update
+        entt::observer changed;
+        std::vector<entt::entity> dirty;
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> depths;
+        uint32_t updatedCount{ 0 };
+
+        // Visits only the changed transforms and their subtrees, idle frames cost nothing
+        void collectDirty(entt::registry& registry) {
+            dirty.clear();
+            for (auto entity : changed) {
+                registry.get<TransformComponent>(entity).markDirty();
+                dirty.push_back(entity);
+            }
+            changed.clear();
+
+            if (registry.storage<HierarchyComponent>().empty()) return;
+
+            // Moving a parent moves its whole subtree
+            for (size_t i = 0; i < dirty.size(); ++i) {
+                const auto* node = registry.try_get<HierarchyComponent>(dirty[i]);
+                if (!node) continue;
+
+                for (auto child = node->firstChild; child != entt::null;) {
+                    auto* transform = registry.try_get<TransformComponent>(child);
+                    if (transform && !transform->isDirty()) {
+                        transform->markDirty();
+                        dirty.push_back(child);
+                    }
+                    child = registry.get<HierarchyComponent>(child).nextSibling;
+                }
+            }
+        }
+
+        void sortByDepth(entt::registry& registry) {
+            order.resize(dirty.size());
+            depths.resize(dirty.size());
+            for (uint32_t i = 0; i < dirty.size(); ++i) {
+                const auto* node = registry.try_get<HierarchyComponent>(dirty[i]);
+                order[i] = i;
+                depths[i] = node ? node->depth : 0;
+            }
+
+            std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+                return depths[a] < depths[b];
+            });
+        }
+    };
+
+    HierarchySystem::HierarchySystem()
+        : System("HierarchySystem", DEFAULT_PRIORITY)
+        , mImpl(new Impl)
+    {
+        declareReads<HierarchyComponent>();
+        declareWrites<TransformComponent>();
+        declareResourceWrites<WorldMatrixUpdates>();
+    }
+
+    HierarchySystem::~HierarchySystem() {
+        delete mImpl;
+    }
+
+    void HierarchySystem::onAttach(entt::registry& registry) {
+        registry.on_destroy<HierarchyComponent>().connect<&onHierarchyDestroyed>();
+        registry.ctx().emplace<WorldMatrixUpdates>();
+        mImpl->changed.connect(registry, entt::collector.group<TransformComponent>().update<TransformComponent>());
+        // Transforms that existed before the system was attached start dirty
+        for (auto entity : registry.view<TransformComponent>()) {
+            registry.patch<TransformComponent>(entity);
+        }
+    }
+
+    void HierarchySystem::onDetach(entt::registry& registry) {
+        registry.on_destroy<HierarchyComponent>().disconnect<&onHierarchyDestroyed>();
+        registry.ctx().erase<WorldMatrixUpdates>();
+        mImpl->changed.disconnect();
+        mImpl->changed.clear();
+    }
+
+    void HierarchySystem::onUpdate(entt::registry& registry, float deltaTime) {
+        mImpl->collectDirty(registry);
+        mImpl->updatedCount = static_cast<uint32_t>(mImpl->dirty.size());
+        if (auto* updates = registry.ctx().find<WorldMatrixUpdates>()) {
+            updates->entities.assign(mImpl->dirty.begin(), mImpl->dirty.end());
+        }
+        if (mImpl->dirty.empty()) return;
+
+        mImpl->transformPass.run(registry, mImpl->dirty.data(), mImpl->dirty.size());
+        const auto* localMatrices = mImpl->transformPass.getModelMatrices();
+
+        if (registry.storage<HierarchyComponent>().empty()) {
+            for (size_t i = 0; i < mImpl->dirty.size(); ++i) {
+                registry.get<TransformComponent>(mImpl->dirty[i]).setWorldMatrix(localMatrices[i]);
+            }
+            return;
+        }
+
+        // Parents are always resolved before their children
+        mImpl->sortByDepth(registry);
+        for (auto index : mImpl->order) {
+            auto entity = mImpl->dirty[index];
+            auto& transform = registry.get<TransformComponent>(entity);
+
+            const TransformComponent* parent = nullptr;
+            if (const auto* node = registry.try_get<HierarchyComponent>(entity); node && node->parent != entt::null) {
+                parent = registry.try_get<TransformComponent>(node->parent);
+            }
+
+            transform.setWorldMatrix(parent
+                ? parent->getWorldMatrix() * localMatrices[index]
+                : localMatrices[index]);
+        }
+    }
+
+    void HierarchySystem::setParent(entt::registry& registry, entt::entity child, entt::entity parent) {
+        if (child == parent) {
+            throw std::runtime_error("Entity cannot be its own parent");
+        }
+
+        if (parent != entt::null) {
+            registry.get_or_emplace<HierarchyComponent>(parent);
+            for (auto ancestor = parent; ancestor != entt::null;
+                ancestor = registry.get<HierarchyComponent>(ancestor).parent) {
+                if (ancestor == child) {
+                    throw std::runtime_error("Cannot parent an entity to its own descendant");
+                }
+            }
+        }
+
+        auto& node = registry.get_or_emplace<HierarchyComponent>(child);
+        unlink(registry, child, node);
+
+        if (parent != entt::null) {
+            auto& parentNode = registry.get<HierarchyComponent>(parent);
+            node.parent = parent;
+            node.nextSibling = parentNode.firstChild;
+            if (parentNode.firstChild != entt::null) {
+                registry.get<HierarchyComponent>(parentNode.firstChild).prevSibling = child;
+            }
+            parentNode.firstChild = child;
+            node.depth = parentNode.depth + 1;
+        }
+        else {
+            node.depth = 0;
+        }
+
+        updateDepths(registry, child);
+        markDirty(registry, child);
+    }
+
+    uint32_t HierarchySystem::getUpdatedCount() const {
+        return mImpl->updatedCount;
+    }
+}
@@ -1,91 +1,568 @@
 #include "saneengine/ecs/systems/rendersystem.hpp"
+#include "saneengine/ecs/paralleleach.hpp"
+#include "saneengine/ecs/components/bounds.hpp"
 #include "saneengine/ecs/components/shader.hpp"
 #include "saneengine/ecs/components/vertex.hpp"
 #include "saneengine/ecs/components/transform.hpp"
-#include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
+#include "saneengine/gfx/commands/rendercommandqueue.hpp"
+#include "saneengine/jobs/jobsystem.hpp"
+#include "saneengine/jobs/perthread.hpp"
+#include "saneengine/math/bvh.hpp"
+#include "saneengine/utils/profiler.hpp"
+#include "saneengine/utils/radixsort.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // Sort key layout, most significant first:
+    //   opaque:      layer:4 | 0 | program:16 | mesh:16 | depth:27 (front to back)
+    //   transparent: layer:4 | 1 | depth:27 (back to front) | program:16 | mesh:16
+    constexpr uint32_t DEPTH_BITS = 27;
+    constexpr uint64_t DEPTH_MASK = (1ull << DEPTH_BITS) - 1;
+
+    // Non-negative float bits order like the floats themselves
+    uint64_t quantizeDepth(float depth) {
+        depth = std::max(depth, 0.0f);
+        uint32_t bits = 0;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return (bits >> (31 - DEPTH_BITS)) & DEPTH_MASK;
+    }
+
+    uint64_t makeSortKey(uint8_t layer, bool transparent, uint32_t program, uint32_t mesh, float depth) {
+        uint64_t key = uint64_t(layer & 0xF) << 60;
+        uint64_t quantized = quantizeDepth(depth);
+        if (!transparent) {
+            return key | uint64_t(program & 0xFFFF) << 43 | uint64_t(mesh & 0xFFFF) << 27 | quantized;
+        }
+        return key | 1ull << 59 | (DEPTH_MASK - quantized) << 32 | uint64_t(program & 0xFFFF) << 16 | (mesh & 0xFFFF);
+    }
+}
 
 namespace sane::ecs {
+    class RenderSystem::Impl {
+    public:
+        // Transparent entities are sorted individually, so each one gets its own batch
+        static constexpr uint32_t SHARED_BATCH = ~0u;
+
+        struct BatchKey {
+            uint32_t programId;
+            uint64_t meshHash;
+            uint8_t layer;
+            uint32_t owner;
+
+            bool operator==(const BatchKey& other) const {
+                return programId == other.programId && meshHash == other.meshHash
+                    && layer == other.layer && owner == other.owner;
+            }
+        };
+
+        struct BatchKeyHash {
+            size_t operator()(const BatchKey& key) const {
+                uint64_t hash = key.meshHash ^ (uint64_t(key.programId) * 0x9E3779B97F4A7C15ull);
+                hash ^= (uint64_t(key.owner) << 8 | key.layer) * 0xC2B2AE3D27D4EB4Full;
+                return std::hash<uint64_t>()(hash);
+            }
+        };
+
+        struct Batch {
+            BatchKey key;
+            std::vector<glm::mat4> instances;
+            std::vector<uint32_t> entities;
+        };
+
+        // Mesh residency: geometry is uploaded once per unique content and
+        // shared by every entity referencing it until the last one goes away.
+        // The GPU copies live with the render thread and are addressed by hash.
+        std::unordered_map<uint64_t, uint32_t> meshReferences;
+        std::unordered_map<entt::entity, uint64_t> entityMeshes;
+        std::vector<entt::entity> changedMeshes;
+        std::vector<entt::entity> releasedMeshes;
+
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        math::Frustum frustum;
+        float elapsedTime{ 0.0f };
+        uint64_t frameIndex{ 0 };
+
+        std::unordered_map<BatchKey, size_t, BatchKeyHash> batchLookup;
+        std::vector<Batch> batches;
+        RenderStats stats;
+
+        // Camera handed in and stats handed out, either side may be on another thread
+        mutable std::mutex sharedMutex;
+        glm::mat4 pendingView{ 1.0f };
+        glm::mat4 pendingProjection{ 1.0f };
+        bool cameraChanged{ false };
+        RenderStats publishedStats;
+
+        void applyCamera() {
+            std::scoped_lock lock(sharedMutex);
+            if (!cameraChanged) return;
+            view = pendingView;
+            projection = pendingProjection;
+            frustum = math::Frustum(projection * view);
+            cameraChanged = false;
+        }
+
+        // Small dense ids keep program and mesh within their sort key fields.
+        // Rebuilt each frame from the batches sorted, so they count only what is drawn.
+        std::unordered_map<uint32_t, uint32_t> programIndices;
+        std::unordered_map<uint64_t, uint32_t> meshIndices;
+        std::vector<utils::SortItem> sortItems;
+        std::vector<utils::SortItem> sortScratch;
+
+        // Culling: one proxy per entity with bounds and a transform, moved as
+        // HierarchySystem reports new world matrices
+        static constexpr size_t MIN_PARALLEL_PROXIES = 4096;
+
+        std::atomic<bool> cullingEnabled{ true };
+        math::DynamicBvh bvh;
+        std::unordered_map<entt::entity, int32_t> proxies;
+        std::vector<entt::entity> removedProxies;
+        // Entities whose vertex data was still empty when it last changed
+        std::vector<entt::entity> pendingBounds;
+        // World boxes computed by each thread when most proxies moved at once
+        jobs::PerThread<std::vector<std::pair<entt::entity, math::Aabb>>> movedBoxes;
+        std::vector<int32_t> subtrees;
+        std::vector<std::vector<uint32_t>> subtreeVisible;
+        std::vector<uint32_t> visible;
+
+        template<typename Key>
+        static uint32_t denseIndex(std::unordered_map<Key, uint32_t>& indices, Key key) {
+            return indices.try_emplace(key, static_cast<uint32_t>(indices.size())).first->second;
+        }
+
+        float viewDepth(const glm::mat4& model) const {
+            const glm::vec4& position = model[3];
+            return -(view[0][2] * position.x + view[1][2] * position.y + view[2][2] * position.z + view[3][2]);
+        }
+
+        void sortBatches() {
+            sortItems.clear();
+            programIndices.clear();
+            meshIndices.clear();
+            for (uint32_t i = 0; i < batches.size(); ++i) {
+                const auto& batch = batches[i];
+                bool transparent = batch.key.owner != SHARED_BATCH;
+
+                // Opaque batches sort by their nearest instance for early depth rejection
+                float depth = viewDepth(batch.instances.front());
+                for (const auto& model : batch.instances) {
+                    depth = std::min(depth, viewDepth(model));
+                }
+
+                uint64_t key = makeSortKey(batch.key.layer, transparent,
+                    denseIndex(programIndices, batch.key.programId),
+                    denseIndex(meshIndices, batch.key.meshHash), depth);
+                sortItems.push_back({ key, i });
+            }
+            utils::radixSort(sortItems, sortScratch);
+        }
+
+        void onVertexChanged(entt::registry& registry, entt::entity entity) {
+            changedMeshes.push_back(entity);
+        }
+
+        void onVertexDestroyed(entt::registry& registry, entt::entity entity) {
+            releasedMeshes.push_back(entity);
+        }
+
+        void onProxyDestroyed(entt::registry& registry, entt::entity entity) {
+            removedProxies.push_back(entity);
+        }
+
+        void applyProxy(entt::entity entity, const math::Aabb& box) {
+            auto [it, inserted] = proxies.try_emplace(entity, math::DynamicBvh::NULL_NODE);
+            if (inserted) {
+                it->second = bvh.insert(box, entt::to_integral(entity));
+            }
+            else {
+                bvh.move(it->second, box);
+            }
+        }
+
+        void updateProxy(entt::registry& registry, entt::entity entity) {
+            const auto* bounds = registry.try_get<BoundsComponent>(entity);
+            const auto* transform = registry.try_get<TransformComponent>(entity);
+            if (!bounds || !transform) return;
+
+            applyProxy(entity, math::transformAabb({ bounds->min, bounds->max }, transform->getWorldMatrix()));
+        }
+
+        // Runs every tick, world matrix updates are only listed for the tick that made them
+        void syncProxies(entt::registry& registry) {
+            for (auto entity : removedProxies) {
+                auto it = proxies.find(entity);
+                if (it == proxies.end()) continue;
+
+                bvh.remove(it->second);
+                proxies.erase(it);
+            }
+            removedProxies.clear();
+
+            const auto& updates = registry.ctx().get<WorldMatrixUpdates>();
+
+            // When most proxies moved, every box is recomputed in parallel. The
+            // tree is still updated serially, and unmoved proxies just fit.
+            if (updates.entities.size() >= std::max(MIN_PARALLEL_PROXIES, proxies.size() / 2)) {
+                movedBoxes.prepare();
+                auto boundedView = registry.view<const BoundsComponent, const TransformComponent>();
+                parallelEach(boundedView, [this](entt::entity entity, const BoundsComponent& bounds,
+                    const TransformComponent& transform) {
+                    movedBoxes.local().emplace_back(entity,
+                        math::transformAabb({ bounds.min, bounds.max }, transform.getWorldMatrix()));
+                });
+                movedBoxes.forEach([this](auto& boxes) {
+                    for (const auto& [entity, box] : boxes) {
+                        applyProxy(entity, box);
+                    }
+                    boxes.clear();
+                });
+                return;
+            }
+
+            for (auto entity : updates.entities) {
+                if (registry.valid(entity)) {
+                    updateProxy(registry, entity);
+                }
+            }
+        }
+
+        void refreshBounds(entt::registry& registry, entt::entity entity, const VertexComponent& vertex) {
+            if (!vertex.getVertices() || vertex.getVertexCount() == 0) {
+                pendingBounds.push_back(entity);
+                return;
+            }
+            registry.emplace_or_replace<BoundsComponent>(entity, BoundsComponent::fromVertices(vertex));
+            updateProxy(registry, entity);
+        }
+
+        void syncBounds(entt::registry& registry) {
+            // Vertex data filled in after the component was constructed
+            auto pending = std::move(pendingBounds);
+            pendingBounds.clear();
+            for (auto entity : pending) {
+                if (!registry.valid(entity)) continue;
+                if (const auto* vertex = registry.try_get<VertexComponent>(entity)) {
+                    refreshBounds(registry, entity, *vertex);
+                }
+            }
+        }
+
+        void collectVisible() {
+            visible.clear();
+            auto* jobSystem = jobs::JobSystem::get();
+            if (!jobSystem || jobSystem->getWorkerCount() == 0 || bvh.getLeafCount() < MIN_PARALLEL_PROXIES) {
+                bvh.query(frustum, bvh.getRoot(), visible);
+                return;
+            }
+
+            // A few subtrees per thread evens out uneven visibility between them
+            bvh.collectSubtrees((jobSystem->getWorkerCount() + 1) * 4, subtrees);
+            subtreeVisible.resize(subtrees.size());
+            jobSystem->parallelFor(subtrees.size(), 1, [this](size_t first, size_t count) {
+                for (size_t task = first; task < first + count; ++task) {
+                    subtreeVisible[task].clear();
+                    bvh.query(frustum, subtrees[task], subtreeVisible[task]);
+                }
+            });
+
+            for (size_t i = 0; i < subtrees.size(); ++i) {
+                visible.insert(visible.end(), subtreeVisible[i].begin(), subtreeVisible[i].end());
+            }
+        }
+
+        void releaseHash(uint64_t hash, gfx::RenderCommandBuffer& commands) {
+            auto it = meshReferences.find(hash);
+            if (it != meshReferences.end() && --it->second == 0) {
+                meshReferences.erase(it);
+                commands.push(gfx::ReleaseMeshCommand{ hash });
+            }
+        }
+
+        void releaseMesh(entt::entity entity, gfx::RenderCommandBuffer& commands) {
+            auto it = entityMeshes.find(entity);
+            if (it == entityMeshes.end()) return;
+
+            releaseHash(it->second, commands);
+            entityMeshes.erase(it);
+        }
+
+        bool acquireMesh(entt::entity entity, const VertexComponent& vertex, gfx::RenderCommandBuffer& commands,
+            uint64_t& outHash) {
+            if (!vertex.getVertices() || vertex.getVertexCount() == 0) {
+                releaseMesh(entity, commands);
+                return false;
+            }
+
+            // The registry hashes geometry once when it is stored
+            outHash = vertex.getMesh()->hash;
+            auto previous = entityMeshes.find(entity);
+            if (previous != entityMeshes.end() && previous->second == outHash) {
+                return true;
+            }
+
+            // The vertex data is copied into the frame, the component may change before replay
+            if (meshReferences[outHash]++ == 0) {
+                const auto& attributes = vertex.getAttributes();
+                gfx::UploadMeshCommand upload{};
+                upload.meshId = outHash;
+                upload.vertexCount = static_cast<uint32_t>(vertex.getVertexCount());
+                upload.vertexDataOffset = commands.pushData(vertex.getVertices(),
+                    upload.vertexCount * 3 * static_cast<uint32_t>(sizeof(float)));
+                upload.attributeDataOffset = commands.pushData(attributes.data(),
+                    static_cast<uint32_t>(attributes.size() * sizeof(gfx::VertexAttribute)));
+                upload.attributeCount = static_cast<uint32_t>(attributes.size());
+                commands.push(upload);
+            }
+
+            if (previous != entityMeshes.end()) {
+                releaseHash(previous->second, commands);
+            }
+            entityMeshes[entity] = outHash;
+            return true;
+        }
+
+        void syncMeshes(entt::registry& registry, gfx::RenderCommandBuffer& commands) {
+            for (auto entity : releasedMeshes) {
+                releaseMesh(entity, commands);
+            }
+            releasedMeshes.clear();
+
+            for (auto entity : changedMeshes) {
+                if (registry.valid(entity)) {
+                    if (const auto* vertex = registry.try_get<VertexComponent>(entity)) {
+                        uint64_t hash = 0;
+                        acquireMesh(entity, *vertex, commands, hash);
+                        refreshBounds(registry, entity, *vertex);
+                    }
+                }
+            }
+            changedMeshes.clear();
+        }
+
+        bool findMesh(entt::entity entity, const VertexComponent& vertex, gfx::RenderCommandBuffer& commands,
+            uint64_t& outHash) {
+            auto it = entityMeshes.find(entity);
+            if (it == entityMeshes.end()) {
+                // Vertex data filled in after the component was constructed
+                return acquireMesh(entity, vertex, commands, outHash);
+            }
+            outHash = it->second;
+            return true;
+        }
+
+        void recordFrame(gfx::RenderCommandBuffer& commands, float deltaTime) {
+            elapsedTime += deltaTime;
+
+            gfx::SetFrameCommand frame;
+            frame.uniforms.view = view;
+            frame.uniforms.projection = projection;
+            frame.uniforms.viewProjection = projection * view;
+            frame.uniforms.time = { elapsedTime, deltaTime, static_cast<float>(frameIndex), 0.0f };
+            commands.push(frame);
+        }
+
+        void recordDraws(gfx::RenderCommandBuffer& commands) {
+            // Every instance matrix of the frame goes out as one contiguous block
+            uint32_t dataOffset = 0;
+            auto* destination = static_cast<uint8_t*>(
+                commands.allocateData(stats.entities * static_cast<uint32_t>(sizeof(glm::mat4)), dataOffset));
+            for (const auto& item : sortItems) {
+                const auto& batch = batches[item.value];
+                auto size = batch.instances.size() * sizeof(glm::mat4);
+                std::memcpy(destination, batch.instances.data(), size);
+                destination += size;
+            }
+
+            uint32_t entityOffset = 0;
+            auto* entityDestination = static_cast<uint8_t*>(
+                commands.allocateData(stats.entities * static_cast<uint32_t>(sizeof(uint32_t)), entityOffset));
+            for (const auto& item : sortItems) {
+                const auto& batch = batches[item.value];
+                auto size = batch.entities.size() * sizeof(uint32_t);
+                std::memcpy(entityDestination, batch.entities.data(), size);
+                entityDestination += size;
+            }
+            commands.push(gfx::SubmitInstancesCommand{ dataOffset, entityOffset, stats.entities });
+
+            // Batches go out in sort key order so the render thread can skip redundant binds
+            uint32_t firstInstance = 0;
+            for (const auto& item : sortItems) {
+                const auto& batch = batches[item.value];
+                auto instanceCount = static_cast<uint32_t>(batch.instances.size());
+                commands.push(gfx::DrawBatchCommand{ batch.key.meshHash, batch.key.programId, firstInstance, instanceCount });
+                firstInstance += instanceCount;
+            }
+        }
+    };
+
     RenderSystem::RenderSystem()
         : System("RenderSystem")
+        , mImpl(new Impl)
     {
+        declareReads<ShaderComponent, VertexComponent, TransformComponent>();
+        declareWrites<BoundsComponent>();
+        declareResourceReads<WorldMatrixUpdates>();
+        // Records into the queue's current buffer
+        declareResourceWrites<gfx::RenderCommandQueue*>();
     }
 
-    RenderSystem::~RenderSystem() = default;
+    RenderSystem::~RenderSystem() {
+        delete mImpl;
+    }
 
     void RenderSystem::onAttach(entt::registry& registry) {
         registry.clear<ShaderComponent>();
         registry.clear<VertexComponent>();
         registry.clear<TransformComponent>();
+        registry.clear<BoundsComponent>();
+
+        registry.on_construct<VertexComponent>().connect<&Impl::onVertexChanged>(*mImpl);
+        registry.on_update<VertexComponent>().connect<&Impl::onVertexChanged>(*mImpl);
+        registry.on_destroy<VertexComponent>().connect<&Impl::onVertexDestroyed>(*mImpl);
+        registry.on_destroy<BoundsComponent>().connect<&Impl::onProxyDestroyed>(*mImpl);
+        registry.on_destroy<TransformComponent>().connect<&Impl::onProxyDestroyed>(*mImpl);
     }
 
     void RenderSystem::onDetach(entt::registry& registry) {
-        auto view = registry.view<ShaderComponent, VertexComponent>();
-        for (auto [entity, shader, vertex] : view.each()) {
-            if (shader.programId) {
-                glDeleteProgram(shader.programId);
-            }
-        }
+        registry.on_construct<VertexComponent>().disconnect<&Impl::onVertexChanged>(*mImpl);
+        registry.on_update<VertexComponent>().disconnect<&Impl::onVertexChanged>(*mImpl);
+        registry.on_destroy<VertexComponent>().disconnect<&Impl::onVertexDestroyed>(*mImpl);
+        registry.on_destroy<BoundsComponent>().disconnect<&Impl::onProxyDestroyed>(*mImpl);
+        registry.on_destroy<TransformComponent>().disconnect<&Impl::onProxyDestroyed>(*mImpl);
 
-        glDeleteVertexArrays(1, &mVao);
-        glDeleteBuffers(1, &mVbo);
+        // GPU meshes are owned by the render thread and go away with it
+        mImpl->meshReferences.clear();
+        mImpl->entityMeshes.clear();
+        mImpl->changedMeshes.clear();
+        mImpl->releasedMeshes.clear();
+        mImpl->batches.clear();
+        mImpl->batchLookup.clear();
+        mImpl->bvh.clear();
+        mImpl->proxies.clear();
+        mImpl->removedProxies.clear();
+        mImpl->pendingBounds.clear();
     }
 
     void RenderSystem::onUpdate(entt::registry& registry, float deltaTime) {
         if (!isEnabled()) return;
+        SANE_PROFILE_SCOPE("RenderSystem::onUpdate");
 
-        static bool sOnce = [this] {
-            glGenVertexArrays(1, &mVao);
-            glGenBuffers(1, &mVbo);
+        // Without it world matrices stay identity and proxies are never refit
+        if (!registry.ctx().contains<WorldMatrixUpdates>()) {
+            throw std::runtime_error("RenderSystem needs a HierarchySystem to keep world matrices current");
+        }
 
-            return true;
-            }();
+        mImpl->applyCamera();
+        mImpl->syncProxies(registry);
 
-        glBindVertexArray(mVao);
+        auto* queue = registry.ctx().find<gfx::RenderCommandQueue*>();
+        auto* commands = queue ? (*queue)->getRecordingBuffer() : nullptr;
+        if (!commands) return;
 
-        auto view = registry.view<ShaderComponent, VertexComponent, TransformComponent>();
-        for (auto entity : view) {
-            const auto& shader = view.get<ShaderComponent>(entity);
-            auto& vertex = view.get<VertexComponent>(entity);
-            const auto& transform = view.get<TransformComponent>(entity);
+        mImpl->syncBounds(registry);
+        mImpl->syncMeshes(registry, *commands);
 
-            glBindBuffer(GL_ARRAY_BUFFER, mVbo);
-            glBufferData(GL_ARRAY_BUFFER,
-                vertex.getVertexCount() * 3 * sizeof(float),
-                vertex.getVertices(),
-                GL_STATIC_DRAW);
+        // Group entities by program, mesh content and draw order
+        for (auto& batch : mImpl->batches) {
+            batch.instances.clear();
+            batch.entities.clear();
+        }
 
+        auto& stats = mImpl->stats;
+        stats = {};
 
-            // Setup attributes
-            for (const auto& attr : vertex.getAttributes()) {
-                glEnableVertexAttribArray(attr.position);
-                glVertexAttribPointer(
-                    attr.position,
-                    attr.count,
-                    attr.type,
-                    attr.normalized ? GL_TRUE : GL_FALSE,
-                    attr.stride,
-                    (void*)attr.offset
-                );
+        auto view = registry.view<ShaderComponent, VertexComponent, TransformComponent>();
+        auto gather = [&](entt::entity entity, const ShaderComponent& shader, const VertexComponent& vertex,
+            const TransformComponent& transform) {
+            uint64_t meshHash = 0;
+            if (!mImpl->findMesh(entity, vertex, *commands, meshHash)) return;
+
+            Impl::BatchKey key{ shader.programId, meshHash, shader.renderLayer,
+                shader.transparent ? entt::to_integral(entity) : Impl::SHARED_BATCH };
+            auto [it, inserted] = mImpl->batchLookup.try_emplace(key, mImpl->batches.size());
+            if (inserted) {
+                mImpl->batches.push_back({ key });
             }
 
-            glUseProgram(shader.programId);
+            auto& batch = mImpl->batches[it->second];
+            batch.instances.push_back(transform.getWorldMatrix());
+            batch.entities.push_back(entt::to_integral(entity));
+            ++stats.entities;
+        };
+
+        if (mImpl->cullingEnabled) {
+            // Only entities whose bounds touch the frustum are looked at
+            mImpl->collectVisible();
+            for (auto id : mImpl->visible) {
+                auto entity = entt::entity{ id };
+                if (view.contains(entity)) {
+                    gather(entity, view.get<ShaderComponent>(entity), view.get<VertexComponent>(entity),
+                        view.get<TransformComponent>(entity));
+                }
+            }
+            stats.culled = static_cast<uint32_t>(mImpl->bvh.getLeafCount() - mImpl->visible.size());
+        }
+        else {
+            for (auto entity : view) {
+                gather(entity, view.get<ShaderComponent>(entity), view.get<VertexComponent>(entity),
+                    view.get<TransformComponent>(entity));
+            }
+        }
 
-            // Set transform uniforms
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), { transform.getPositionX(), transform.getPositionY(), transform.getPositionZ() });
-            model = glm::rotate(model, transform.getRotationX(), glm::vec3(1.0f, 0.0f, 0.0f));
-            model = glm::rotate(model, transform.getRotationY(), glm::vec3(0.0f, 1.0f, 0.0f));
-            model = glm::rotate(model, transform.getRotationZ(), glm::vec3(0.0f, 0.0f, 1.0f));
-            model = glm::scale(model, { transform.getScaleX(), transform.getScaleY(), transform.getScaleZ() });
+        // Drop batches that went empty so the lookup does not grow unbounded
+        auto emptyBatch = [](const Impl::Batch& batch) { return batch.instances.empty(); };
+        if (std::any_of(mImpl->batches.begin(), mImpl->batches.end(), emptyBatch)) {
+            mImpl->batches.erase(std::remove_if(mImpl->batches.begin(), mImpl->batches.end(), emptyBatch),
+                mImpl->batches.end());
+            mImpl->batchLookup.clear();
+            for (size_t i = 0; i < mImpl->batches.size(); ++i) {
+                mImpl->batchLookup.emplace(mImpl->batches[i].key, i);
+            }
+        }
 
-            GLint modelLoc = glGetUniformLocation(shader.programId, "model");
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        mImpl->sortBatches();
+        mImpl->recordFrame(*commands, deltaTime);
+        mImpl->recordDraws(*commands);
 
-            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertex.getVertexCount());
+        auto submitted = (*queue)->getLastSubmitStats();
+        stats.batches = static_cast<uint32_t>(mImpl->batches.size());
+        stats.drawCalls = submitted.drawCalls;
+        stats.programBinds = submitted.programBinds;
+        stats.vertexArrayBinds = submitted.vertexArrayBinds;
+        stats.bufferBinds = submitted.bufferBinds;
+        stats.mergedDraws = stats.entities > submitted.drawCalls ? stats.entities - submitted.drawCalls : 0;
+        {
+            std::scoped_lock lock(mImpl->sharedMutex);
+            mImpl->publishedStats = stats;
         }
+        ++mImpl->frameIndex;
+    }
+
+    void RenderSystem::setCamera(const glm::mat4& view, const glm::mat4& projection) {
+        std::scoped_lock lock(mImpl->sharedMutex);
+        mImpl->pendingView = view;
+        mImpl->pendingProjection = projection;
+        mImpl->cameraChanged = true;
+    }
+
+    void RenderSystem::setCullingEnabled(bool enabled) {
+        mImpl->cullingEnabled = enabled;
+    }
+
+    bool RenderSystem::isCullingEnabled() const {
+        return mImpl->cullingEnabled;
+    }
 
-        glBindVertexArray(0);
+    RenderStats RenderSystem::getStats() const {
+        std::scoped_lock lock(mImpl->sharedMutex);
+        return mImpl->publishedStats;
     }
 
-}
\ No newline at end of file
+}
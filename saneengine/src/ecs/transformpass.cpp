@@ -0,0 +1,99 @@
+#include "saneengine/ecs/transformpass.hpp"
+#include "saneengine/ecs/components/transform.hpp"
+#include "saneengine/jobs/jobsystem.hpp"
+#include "saneengine/math/simdtransform.hpp"
+#include "saneengine/utils/alignedallocator.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace sane::ecs {
+    class TransformPass::Impl {
+    public:
+        // Below this many transforms starting jobs costs more than it saves
+        static constexpr size_t MIN_PARALLEL_COUNT = 4096;
+        // Multiple of the widest SIMD lane count so chunks never split a vector
+        static constexpr size_t CHUNK_SIZE = 1024;
+
+        using FloatArray = std::vector<float, utils::AlignedAllocator<float, 64>>;
+
+        FloatArray posX, posY, posZ;
+        FloatArray rotX, rotY, rotZ;
+        FloatArray scaleX, scaleY, scaleZ;
+        std::vector<glm::mat4, utils::AlignedAllocator<glm::mat4, 64>> matrices;
+
+        const entt::storage_for_t<TransformComponent>* transforms{ nullptr };
+        const entt::entity* entities{ nullptr };
+        size_t count{ 0 };
+
+        void resize(size_t size) {
+            for (auto* array : { &posX, &posY, &posZ, &rotX, &rotY, &rotZ, &scaleX, &scaleY, &scaleZ }) {
+                array->resize(size);
+            }
+            matrices.resize(size);
+        }
+
+        void process(size_t first, size_t size) {
+            for (size_t i = first; i < first + size; ++i) {
+                const auto& transform = transforms->get(entities[i]);
+                posX[i] = transform.getPositionX();
+                posY[i] = transform.getPositionY();
+                posZ[i] = transform.getPositionZ();
+                rotX[i] = transform.getRotationX();
+                rotY[i] = transform.getRotationY();
+                rotZ[i] = transform.getRotationZ();
+                scaleX[i] = transform.getScaleX();
+                scaleY[i] = transform.getScaleY();
+                scaleZ[i] = transform.getScaleZ();
+            }
+
+            math::TransformSoA soa{
+                posX.data(), posY.data(), posZ.data(),
+                rotX.data(), rotY.data(), rotZ.data(),
+                scaleX.data(), scaleY.data(), scaleZ.data()
+            };
+            math::composeModelMatrices(soa, first, size, &matrices[0][0][0]);
+        }
+
+        void dispatch() {
+            auto* jobSystem = jobs::JobSystem::get();
+            if (!jobSystem || count < MIN_PARALLEL_COUNT) {
+                for (size_t first = 0; first < count; first += CHUNK_SIZE) {
+                    process(first, std::min(CHUNK_SIZE, count - first));
+                }
+                return;
+            }
+            // Split over whole chunks so pieces never start mid vector
+            size_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            jobSystem->parallelFor(chunkCount, 1, [this](size_t firstChunk, size_t chunks) {
+                size_t first = firstChunk * CHUNK_SIZE;
+                process(first, std::min(chunks * CHUNK_SIZE, count - first));
+            });
+        }
+    };
+
+    TransformPass::TransformPass() : mImpl(new Impl()) {
+    }
+
+    TransformPass::~TransformPass() {
+        delete mImpl;
+    }
+
+    void TransformPass::run(entt::registry& registry, const entt::entity* entities, size_t count) {
+        mImpl->transforms = &registry.storage<TransformComponent>();
+        mImpl->entities = entities;
+        mImpl->count = count;
+        mImpl->resize(count);
+
+        if (mImpl->count > 0) {
+            mImpl->dispatch();
+        }
+    }
+
+    const glm::mat4* TransformPass::getModelMatrices() const {
+        return mImpl->matrices.data();
+    }
+
+    size_t TransformPass::size() const {
+        return mImpl->count;
+    }
+}
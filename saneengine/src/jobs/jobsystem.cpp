@@ -0,0 +1,356 @@
+#include "saneengine/jobs/jobsystem.hpp"
+#include "saneengine/jobs/workstealingdeque.hpp"
+#include "saneengine/utils/framearena.hpp"
+#include "saneengine/utils/profiler.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sane::jobs {
+    class JobSystem::Impl {
+    public:
+        static constexpr size_t DEQUE_CAPACITY = 4096;
+        static constexpr size_t JOBS_PER_BLOCK = 256;
+        // Threads other than the workers that may start jobs at once (simulation, render, main, ...)
+        static constexpr uint32_t MAX_EXTERNAL_THREADS = 8;
+        // Failed steal rounds before a worker goes to sleep
+        static constexpr uint32_t SPIN_COUNT = 64;
+
+        // Per-thread deque and job pool. Jobs always go back to the pool they
+        // came from; ones finished on other threads are handed back lock-free.
+        struct Context {
+            WorkStealingDeque<Job, DEQUE_CAPACITY> deque;
+            std::thread::id thread;
+            std::vector<Job*> freeJobs;
+            std::atomic<Job*> returnedJobs{ nullptr };
+            std::vector<std::unique_ptr<Job[]>> blocks;
+            uint32_t random{ 0 };
+        };
+
+        // Context of the calling thread in the system it last used, zero initialized.
+        // Systems are told apart by id, a new one may reuse a destroyed one's address.
+        struct Binding {
+            uint64_t system;
+            Context* context;
+        };
+        static inline thread_local Binding tBinding;
+        static inline std::atomic<uint64_t> sNextId{ 1 };
+
+        // External slots the calling thread holds, handed back when it exits
+        struct ThreadSlots {
+            std::vector<Binding> slots;
+            ~ThreadSlots();
+        };
+        static inline thread_local ThreadSlots tSlots;
+        // Systems still alive by id, a thread may outlive the ones it used
+        static inline std::mutex sLiveMutex;
+        static inline std::unordered_map<uint64_t, Impl*> sLive;
+
+        const uint64_t id{ sNextId.fetch_add(1, std::memory_order_relaxed) };
+        uint32_t workerCount;
+        std::vector<std::thread> workers;
+        std::unique_ptr<Context[]> contexts;
+        std::atomic<uint32_t> contextCount{ 0 };
+        std::mutex registerMutex;
+
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<uint64_t> signal{ 0 };
+        std::atomic<uint32_t> sleepers{ 0 };
+        std::atomic<bool> stopping{ false };
+
+        explicit Impl(uint32_t inWorkerCount)
+            : workerCount(inWorkerCount)
+            , contexts(new Context[inWorkerCount + MAX_EXTERNAL_THREADS])
+        {
+            std::scoped_lock lock(sLiveMutex);
+            sLive.emplace(id, this);
+        }
+
+        ~Impl() {
+            std::scoped_lock lock(sLiveMutex);
+            sLive.erase(id);
+        }
+
+        Context& getContext();
+
+        Job* allocate(Context& context) {
+            if (context.freeJobs.empty()) {
+                for (Job* job = context.returnedJobs.exchange(nullptr, std::memory_order_acquire); job;) {
+                    Job* next = job->next;
+                    context.freeJobs.push_back(job);
+                    job = next;
+                }
+            }
+            if (context.freeJobs.empty()) {
+                auto& block = context.blocks.emplace_back(new Job[JOBS_PER_BLOCK]);
+                for (size_t i = 0; i < JOBS_PER_BLOCK; ++i) {
+                    block[i].owner = &context;
+                    context.freeJobs.push_back(&block[i]);
+                }
+            }
+
+            Job* job = context.freeJobs.back();
+            context.freeJobs.pop_back();
+            return job;
+        }
+
+        void release(Context& context, Job* job) {
+            auto* home = static_cast<Context*>(job->owner);
+            if (home == &context) {
+                context.freeJobs.push_back(job);
+                return;
+            }
+
+            // Only the owner takes the list, and it takes all of it, so there is no ABA
+            Job* head = home->returnedJobs.load(std::memory_order_relaxed);
+            do {
+                job->next = head;
+            } while (!home->returnedJobs.compare_exchange_weak(head, job,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Job* find(Context& context) {
+            if (Job* job = context.deque.pop()) {
+                return job;
+            }
+
+            // Start stealing at a random victim so thieves spread out
+            uint32_t count = contextCount.load(std::memory_order_acquire);
+            context.random ^= context.random << 13;
+            context.random ^= context.random >> 17;
+            context.random ^= context.random << 5;
+            for (uint32_t i = 0, start = context.random % count; i < count; ++i) {
+                auto& victim = contexts[(start + i) % count];
+                if (&victim == &context) continue;
+                if (Job* job = victim.deque.steal()) {
+                    return job;
+                }
+            }
+            return nullptr;
+        }
+
+        void execute(Context& context, Job* job) {
+            JobCounter* counter = job->counter;
+            try {
+                // What the job takes from the frame arena goes away with it
+                utils::FrameArena::Scope scope(utils::FrameArena::get());
+                job->invoke(*job);
+            }
+            catch (...) {
+                if (!counter) {
+                    std::terminate();
+                }
+                if (!counter->mFailed.exchange(true, std::memory_order_relaxed)) {
+                    counter->mError = std::current_exception();
+                }
+            }
+            release(context, job);
+
+            // Last touch of the counter, the waiter may destroy it right after
+            if (counter) {
+                counter->mPending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+        void wake() {
+            signal.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers.load(std::memory_order_seq_cst) > 0) {
+                { std::scoped_lock lock(sleepMutex); }
+                sleepCondition.notify_one();
+            }
+        }
+
+        void workerLoop(Context& context) {
+            uint32_t idle = 0;
+            for (;;) {
+                if (Job* job = find(context)) {
+                    execute(context, job);
+                    idle = 0;
+                    continue;
+                }
+                if (stopping.load(std::memory_order_acquire)) {
+                    return;
+                }
+                if (++idle < SPIN_COUNT) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // Announce the sleep first, then look once more, so a job
+                // pushed in between either is found or wakes this thread
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                uint64_t seen = signal.load(std::memory_order_seq_cst);
+                if (Job* job = find(context)) {
+                    sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    execute(context, job);
+                    idle = 0;
+                    continue;
+                }
+
+                std::unique_lock lock(sleepMutex);
+                sleepCondition.wait(lock, [&] {
+                    return stopping.load(std::memory_order_relaxed) || signal.load(std::memory_order_relaxed) != seen;
+                });
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                idle = 0;
+            }
+        }
+    };
+
+    namespace {
+        std::atomic<JobSystem*> sInstance{ nullptr };
+    }
+
+    JobSystem::Impl::ThreadSlots::~ThreadSlots() {
+        std::scoped_lock liveLock(sLiveMutex);
+        for (const auto& slot : slots) {
+            auto live = sLive.find(slot.system);
+            if (live == sLive.end()) continue;
+
+            // The deque and pool stay, the next thread taking the slot owns
+            // them from then on, including any jobs still queued
+            std::scoped_lock lock(live->second->registerMutex);
+            slot.context->thread = std::thread::id();
+        }
+    }
+
+    JobSystem::Impl::Context& JobSystem::Impl::getContext() {
+        if (tBinding.system == id) {
+            return *tBinding.context;
+        }
+
+        {
+            // Forget slots of destroyed systems, before registerMutex which the exit hook takes second
+            std::scoped_lock liveLock(sLiveMutex);
+            std::erase_if(tSlots.slots, [](const Binding& slot) { return !sLive.count(slot.system); });
+        }
+
+        std::scoped_lock lock(registerMutex);
+        auto thread = std::this_thread::get_id();
+        uint32_t count = contextCount.load(std::memory_order_relaxed);
+        Context* context = nullptr;
+        Context* unused = nullptr;
+        for (uint32_t i = workerCount; i < count; ++i) {
+            if (contexts[i].thread == thread) {
+                context = &contexts[i];
+                break;
+            }
+            if (!unused && contexts[i].thread == std::thread::id()) {
+                unused = &contexts[i];
+            }
+        }
+
+        if (!context) {
+            if (unused) {
+                context = unused;
+            }
+            else {
+                if (count == workerCount + MAX_EXTERNAL_THREADS) {
+                    throw std::runtime_error("Too many threads starting jobs");
+                }
+                context = &contexts[count];
+                context->random = count * 2654435761u + 1;
+                contextCount.store(count + 1, std::memory_order_release);
+            }
+            context->thread = thread;
+            tSlots.slots.push_back({ id, context });
+        }
+
+        tBinding = { id, context };
+        return *context;
+    }
+
+    JobSystem::JobSystem(uint32_t workerCount) {
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+        mImpl = new Impl(workerCount);
+
+        // Worker contexts take the first slots so they are visible to every thief
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            mImpl->contexts[i].random = i * 2654435761u + 1;
+        }
+        mImpl->contextCount.store(workerCount, std::memory_order_release);
+
+        mImpl->workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            mImpl->workers.emplace_back([this, i] {
+                auto& context = mImpl->contexts[i];
+                context.thread = std::this_thread::get_id();
+                Impl::tBinding = { mImpl->id, &context };
+                SANE_PROFILE_THREAD("Worker " + std::to_string(i));
+                mImpl->workerLoop(context);
+            });
+        }
+
+        JobSystem* expected = nullptr;
+        sInstance.compare_exchange_strong(expected, this);
+    }
+
+    JobSystem::~JobSystem() {
+        JobSystem* expected = this;
+        sInstance.compare_exchange_strong(expected, nullptr);
+
+        mImpl->stopping.store(true, std::memory_order_release);
+        {
+            std::scoped_lock lock(mImpl->sleepMutex);
+        }
+        mImpl->sleepCondition.notify_all();
+        for (auto& worker : mImpl->workers) {
+            worker.join();
+        }
+        delete mImpl;
+    }
+
+    JobSystem* JobSystem::get() {
+        return sInstance.load(std::memory_order_acquire);
+    }
+
+    void JobSystem::wait(JobCounter& counter) {
+        auto& context = mImpl->getContext();
+        while (!counter.isDone()) {
+            if (Job* job = mImpl->find(context)) {
+                mImpl->execute(context, job);
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (counter.mFailed.exchange(false, std::memory_order_acquire)) {
+            auto error = std::move(counter.mError);
+            counter.mError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    uint32_t JobSystem::getWorkerCount() const {
+        return mImpl->workerCount;
+    }
+
+    uint32_t JobSystem::getThreadCapacity() const {
+        return mImpl->workerCount + Impl::MAX_EXTERNAL_THREADS;
+    }
+
+    uint32_t JobSystem::getThreadIndex() {
+        return static_cast<uint32_t>(&mImpl->getContext() - mImpl->contexts.get());
+    }
+
+    JobSystem::Job* JobSystem::allocateJob() {
+        return mImpl->allocate(mImpl->getContext());
+    }
+
+    void JobSystem::submit(Job* job) {
+        auto& context = mImpl->getContext();
+        if (mImpl->workerCount == 0 || !context.deque.push(job)) {
+            // Nobody could take it, or the deque is full: run it right here
+            mImpl->execute(context, job);
+            return;
+        }
+        mImpl->wake();
+    }
+}
@@ -1,21 +1,18 @@
 #include "saneengine/layer/imguicontextmanager.hpp"
+#include "saneengine/utils/frametimestats.hpp"
+#include "saneengine/utils/profiler.hpp"
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <GLFW/glfw3.h>
-#include <vector>
-#include <algorithm>
-#include <numeric>
 
 namespace sane {
     class ImGuiContextManager::Impl {
     public:
         bool initialized{ false };
         bool frameStarted{ false };
-        std::vector<float> frameTimeHistory;
-        float averageFPS{ 0.0f };
-        float onePercentLow{ 0.0f };
-        float pointOnePercentLow{ 0.0f };
+        // About as long as the 1000 frames it used to keep at 60 fps
+        utils::FrameTimeStats frameTimes{ 15.0f };
     };
 
     ImGuiContextManager::ImGuiContextManager() : mImpl(new Impl) {}
@@ -26,19 +23,24 @@ namespace sane {
     }
 
     void ImGuiContextManager::initialize() {
-        if (!mImpl->initialized) {
+        // Headless EGL contexts have no GLFW window for the backend to use
+        GLFWwindow* window = glfwGetCurrentContext();
+        if (!mImpl->initialized && window) {
             IMGUI_CHECKVERSION();
             ImGui::CreateContext();
             ImGuiIO& io = ImGui::GetIO();
             io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-            io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+            // Viewports would open visible windows next to a hidden headless one
+            if (glfwGetWindowAttrib(window, GLFW_VISIBLE)) {
+                io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+            }
 
             ImGui::StyleColorsDark();
             ImGuiStyle& style = ImGui::GetStyle();
             style.WindowRounding = 0.0f;
             style.Colors[ImGuiCol_WindowBg].w = 1.0f;
 
-            ImGui_ImplGlfw_InitForOpenGL(glfwGetCurrentContext(), true);
+            ImGui_ImplGlfw_InitForOpenGL(window, true);
             ImGui_ImplOpenGL3_Init("#version 330");
 
             mImpl->initialized = true;
@@ -59,6 +61,7 @@ namespace sane {
     }
 
     void ImGuiContextManager::beginFrame() {
+        SANE_PROFILE_SCOPE("ImGui::beginFrame");
         if (!mImpl->frameStarted && mImpl->initialized) {
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
@@ -68,6 +71,7 @@ namespace sane {
     }
 
     void ImGuiContextManager::endFrame() {
+        SANE_PROFILE_SCOPE("ImGui::endFrame");
         if (mImpl->frameStarted && mImpl->initialized) {
             ImGui::Render();
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -84,35 +88,11 @@ namespace sane {
     }
 
     void ImGuiContextManager::updateStats(float deltaTime) {
-        static constexpr size_t MAX_FRAMES = 1000;
-        auto& history = mImpl->frameTimeHistory;
-
-        if (history.size() < MAX_FRAMES) {
-            history.push_back(deltaTime);
-        }
-        else {
-            static size_t currentIndex = 0;
-            history[currentIndex] = deltaTime;
-            currentIndex = (currentIndex + 1) % MAX_FRAMES;
-        }
-
-        float avgFrameTime = std::accumulate(history.begin(),
-            history.end(), 0.0f) / history.size();
-        mImpl->averageFPS = 1.0f / avgFrameTime;
-
-        std::vector<float> sortedTimes = history;
-        std::sort(sortedTimes.begin(), sortedTimes.end(), std::greater<float>());
-
-        size_t onePercentIndex = history.size() / 100;
-        size_t pointOnePercentIndex = history.size() / 1000;
-
-        mImpl->onePercentLow = onePercentIndex > 0 ?
-            1.0f / sortedTimes[onePercentIndex - 1] : 0.0f;
-        mImpl->pointOnePercentLow = pointOnePercentIndex > 0 ?
-            1.0f / sortedTimes[pointOnePercentIndex - 1] : 0.0f;
+        mImpl->frameTimes.add(deltaTime);
+        mImpl->frameTimes.publish();
     }
 
-    float ImGuiContextManager::getAverageFPS() const { return mImpl->averageFPS; }
-    float ImGuiContextManager::getOnePercentLow() const { return mImpl->onePercentLow; }
-    float ImGuiContextManager::getPointOnePercentLow() const { return mImpl->pointOnePercentLow; }
+    float ImGuiContextManager::getAverageFPS() const { return mImpl->frameTimes.getSnapshot(0).getAverageFps(); }
+    float ImGuiContextManager::getOnePercentLow() const { return mImpl->frameTimes.getSnapshot(0).getOnePercentLow(); }
+    float ImGuiContextManager::getPointOnePercentLow() const { return mImpl->frameTimes.getSnapshot(0).getPointOnePercentLow(); }
 }
\ No newline at end of file
@@ -33,16 +33,13 @@ namespace sane {
     void ImGuiLayer::onDetach() {
     }
 
-    void ImGuiLayer::onUpdate(float deltaTime) {
+    void ImGuiLayer::onRender() {
         mImpl->initializeContext();
         if (!mImpl->contextManager.isInitialized()) return;
 
         mImpl->contextManager.beginFrame();
-        mImpl->contextManager.updateStats(deltaTime);
-    }
-
-    void ImGuiLayer::onRender() {
-        if (!mImpl->contextManager.isInitialized()) return;
+        mImpl->contextManager.updateStats(ImGui::GetIO().DeltaTime);
+        onImGui();
         mImpl->contextManager.endFrame();
     }
 }
\ No newline at end of file
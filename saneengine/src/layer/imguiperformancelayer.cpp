@@ -1,36 +1,135 @@
 #include "saneengine/layer/imguiperformancelayer.hpp"
+#include "saneengine/utils/frametimestats.hpp"
+#include "saneengine/utils/profiler.hpp"
+#include "saneengine/utils/timings.hpp"
 #include <imgui.h>
 #include <vector>
 #include <algorithm>
+#include <cfloat>
+#include <stdexcept>
+#include <string>
 
 namespace sane {
     class ImGuiPerformanceLayer::Impl {
     public:
-        static constexpr size_t MAX_SAMPLES = 100;
-        std::vector<float> frameTimeHistory;
-        float onePercentLow{ 0.0f };
-        float pointOnePercentLow{ 0.0f };
+        // 1 s, 10 s and 60 s windows
+        utils::FrameTimeStats frameTimes;
         ImVec2 lastWindowPos{ 10.0f, 10.0f };
 
+        static constexpr const char* TRACE_PATH = "sane_trace.json";
+        std::string captureStatus;
+
         void updateStats(float deltaTime) {
-            if (frameTimeHistory.size() >= MAX_SAMPLES) {
-                frameTimeHistory.erase(frameTimeHistory.begin());
+            frameTimes.add(deltaTime);
+            frameTimes.publish();
+        }
+
+        static const char* kindName(utils::TimingKind kind) {
+            switch (kind) {
+            case utils::TimingKind::System: return "System";
+            case utils::TimingKind::LayerUpdate: return "Layer update";
+            case utils::TimingKind::LayerRender: return "Layer render";
+            case utils::TimingKind::RenderPass: return "Render pass";
+            case utils::TimingKind::GpuPass: return "GPU pass";
+            }
+            return "";
+        }
+
+        // Sorts by the column the table's sort specs name, average by default
+        static void sortStats(std::vector<utils::TimingStats>& stats, const ImGuiTableSortSpecs* specs) {
+            int16_t column = 2;
+            bool descending = true;
+            if (specs && specs->SpecsCount > 0) {
+                column = specs->Specs[0].ColumnIndex;
+                descending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+            }
+
+            std::stable_sort(stats.begin(), stats.end(), [column, descending](const auto& a, const auto& b) {
+                int order = 0;
+                switch (column) {
+                case 0: order = a.name.compare(b.name); break;
+                case 1: order = static_cast<int>(a.kind) - static_cast<int>(b.kind); break;
+                case 2: order = (a.average > b.average) - (a.average < b.average); break;
+                case 3: order = (a.p99 > b.p99) - (a.p99 < b.p99); break;
+                case 4: order = (a.max > b.max) - (a.max < b.max); break;
+                }
+                return descending ? order > 0 : order < 0;
+            });
+        }
+
+        // Starts and stops a profiler capture, saved to the working directory
+        void drawCaptureControls() {
+            auto& profiler = utils::Profiler::get();
+            if (!profiler.isCapturing()) {
+                if (ImGui::SmallButton("Capture trace")) {
+                    profiler.beginCapture();
+                    captureStatus = "Capturing...";
+                }
+            }
+            else if (ImGui::SmallButton("Stop capture")) {
+                try {
+                    size_t events = profiler.endCapture(TRACE_PATH);
+                    captureStatus = std::to_string(events) + " events in " + TRACE_PATH;
+                }
+                catch (const std::exception& error) {
+                    captureStatus = error.what();
+                }
+            }
+            if (!captureStatus.empty()) {
+                ImGui::TextUnformatted(captureStatus.c_str());
+            }
+        }
+
+        // Where each system and layer spends its time, in microseconds
+        void drawTimings() {
+            if constexpr (!utils::TIMINGS_ENABLED) {
+                return;
             }
-            frameTimeHistory.push_back(deltaTime);
 
-            // Sort frame times (higher times = lower FPS)
-            std::vector<float> sortedTimes = frameTimeHistory;
-            std::sort(sortedTimes.begin(), sortedTimes.end(), std::greater<float>());
+            ImGui::SetNextWindowSize(ImVec2(560, 300), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Timings")) {
+                ImGui::End();
+                return;
+            }
+
+            auto stats = utils::Timings::get().query();
+            constexpr ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg |
+                ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+            if (ImGui::BeginTable("timings", 6, flags)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Kind");
+                ImGui::TableSetupColumn("Avg us", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("p99 us", ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("Max us", ImGuiTableColumnFlags_PreferSortDescending);
+                ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_NoSort | ImGuiTableColumnFlags_WidthFixed, 140.0f);
+                ImGui::TableHeadersRow();
 
-            // Calculate percentile indices
-            size_t onePercentIndex = frameTimeHistory.size() / 10;
-            size_t pointOnePercentIndex = frameTimeHistory.size() / 100;
+                // Samples change every frame, so sort every frame rather than only when the specs do
+                sortStats(stats, ImGui::TableGetSortSpecs());
 
-            // Calculate 1% and 0.1% lows
-            onePercentLow = onePercentIndex > 0 ?
-                1.0f / sortedTimes[onePercentIndex - 1] : 0.0f;
-            pointOnePercentLow = pointOnePercentIndex > 0 ?
-                1.0f / sortedTimes[pointOnePercentIndex - 1] : 0.0f;
+                for (size_t i = 0; i < stats.size(); ++i) {
+                    const auto& entry = stats[i];
+                    ImGui::PushID(static_cast<int>(i));
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(entry.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(kindName(entry.kind));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%8.1f", entry.average);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%8.1f", entry.p99);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%8.1f", entry.max);
+                    ImGui::TableNextColumn();
+                    ImGui::PlotLines("##history", entry.history.data(), static_cast<int>(entry.history.size()),
+                        0, nullptr, 0.0f, FLT_MAX, ImVec2(-FLT_MIN, ImGui::GetTextLineHeight()));
+                    ImGui::PopID();
+                }
+                ImGui::EndTable();
+            }
+            ImGui::End();
         }
     };
 
@@ -44,9 +143,8 @@ namespace sane {
         delete mImpl;
     }
 
-    void ImGuiPerformanceLayer::onUpdate(float deltaTime) {
-        mImpl->updateStats(deltaTime);
-        ImGuiLayer::onUpdate(deltaTime);
+    void ImGuiPerformanceLayer::onImGui() {
+        mImpl->updateStats(ImGui::GetIO().DeltaTime);
 
         const ImGuiViewport* main_viewport = ImGui::GetMainViewport();
         ImGui::SetNextWindowBgAlpha(0.35f);
@@ -74,8 +172,17 @@ namespace sane {
 
         // Display FPS stats
         ImGui::Text("Average FPS: %6.1f", ImGui::GetIO().Framerate);
-        ImGui::Text("1%% Low: %6.1f", mImpl->onePercentLow);
-        ImGui::Text("0.1%% Low: %6.1f", mImpl->pointOnePercentLow);
+        ImGui::TextUnformatted("1% / 0.1% Low:");
+        for (size_t window = 0; window < mImpl->frameTimes.getWindowCount(); ++window) {
+            auto snapshot = mImpl->frameTimes.getSnapshot(window);
+            ImGui::Text("%3.0fs %6.1f / %6.1f", mImpl->frameTimes.getWindowLength(window),
+                snapshot.getOnePercentLow(), snapshot.getPointOnePercentLow());
+        }
+#if SANEENGINE_PROFILER
+        mImpl->drawCaptureControls();
+#endif
         ImGui::End();
+
+        mImpl->drawTimings();
     }
 }
\ No newline at end of file
@@ -6,14 +6,23 @@ namespace sane {
     public:
         std::string name;
         int32_t priority{ 0 };
+        std::shared_ptr<utils::TimingTrack> updateTiming;
+        std::shared_ptr<utils::TimingTrack> renderTiming;
     };
 
     Layer::Layer(const char* name, int32_t priority) : mImpl(new Impl) {
         mImpl->name = name;
         mImpl->priority = priority;
+        mImpl->updateTiming = utils::Timings::get().addTrack(name, utils::TimingKind::LayerUpdate);
+        mImpl->renderTiming = utils::Timings::get().addTrack(name, utils::TimingKind::LayerRender);
     }
 
     Layer::~Layer() {
+        for (const auto& timing : { mImpl->updateTiming, mImpl->renderTiming }) {
+            if (timing) {
+                utils::Timings::get().removeTrack(timing.get());
+            }
+        }
         delete mImpl;
     }
 
@@ -28,4 +37,12 @@ namespace sane {
     void Layer::setPriority(int32_t priority) {
         mImpl->priority = priority;
     }
+
+    utils::TimingTrack* Layer::getUpdateTiming() const {
+        return mImpl->updateTiming.get();
+    }
+
+    utils::TimingTrack* Layer::getRenderTiming() const {
+        return mImpl->renderTiming.get();
+    }
 }
\ No newline at end of file
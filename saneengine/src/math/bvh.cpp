@@ -0,0 +1,316 @@
+#include "saneengine/math/bvh.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    using sane::math::Aabb;
+
+    Aabb merge(const Aabb& a, const Aabb& b) {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+
+    bool contains(const Aabb& outer, const Aabb& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+            && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    float surfaceArea(const Aabb& box) {
+        glm::vec3 size = box.max - box.min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    // Margin scales with the object so small and large ones both get room to move
+    Aabb fatten(const Aabb& box) {
+        glm::vec3 margin = (box.max - box.min) * 0.1f + glm::vec3(0.05f);
+        return { box.min - margin, box.max + margin };
+    }
+}
+
+namespace sane::math {
+    int32_t DynamicBvh::insert(const Aabb& inBox, uint32_t inUserData) {
+        int32_t leaf = allocateNode();
+        auto& node = mNodes[leaf];
+        node.box = fatten(inBox);
+        node.userData = inUserData;
+        node.height = 0;
+
+        insertLeaf(leaf);
+        ++mLeafCount;
+        return leaf;
+    }
+
+    void DynamicBvh::remove(int32_t inProxy) {
+        if (inProxy < 0 || inProxy >= static_cast<int32_t>(mNodes.size()) || !mNodes[inProxy].isLeaf()
+            || mNodes[inProxy].height < 0) {
+            throw std::runtime_error("Invalid BVH proxy");
+        }
+
+        removeLeaf(inProxy);
+        freeNode(inProxy);
+        --mLeafCount;
+    }
+
+    bool DynamicBvh::move(int32_t inProxy, const Aabb& inBox) {
+        if (contains(mNodes[inProxy].box, inBox)) {
+            return false;
+        }
+
+        removeLeaf(inProxy);
+        mNodes[inProxy].box = fatten(inBox);
+        insertLeaf(inProxy);
+        return true;
+    }
+
+    void DynamicBvh::clear() {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mLeafCount = 0;
+    }
+
+    int32_t DynamicBvh::getRoot() const {
+        return mRoot;
+    }
+
+    size_t DynamicBvh::getLeafCount() const {
+        return mLeafCount;
+    }
+
+    void DynamicBvh::collectSubtrees(size_t inTargetCount, std::vector<int32_t>& outRoots) const {
+        outRoots.clear();
+        if (mRoot == NULL_NODE) return;
+
+        // Breadth first, so the subtrees end up of similar size in a balanced tree
+        outRoots.push_back(mRoot);
+        std::vector<int32_t> next;
+        while (outRoots.size() < inTargetCount) {
+            bool split = false;
+            next.clear();
+            for (auto index : outRoots) {
+                const auto& node = mNodes[index];
+                if (node.isLeaf()) {
+                    next.push_back(index);
+                    continue;
+                }
+                next.push_back(node.child1);
+                next.push_back(node.child2);
+                split = true;
+            }
+            outRoots.swap(next);
+            if (!split) break;
+        }
+    }
+
+    void DynamicBvh::query(const Frustum& inFrustum, int32_t inRoot, std::vector<uint32_t>& outVisible) const {
+        if (inRoot == NULL_NODE) return;
+
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(inRoot);
+        while (!stack.empty()) {
+            int32_t index = stack.back();
+            stack.pop_back();
+
+            const auto& node = mNodes[index];
+            auto containment = inFrustum.test(node.box);
+            if (containment == Containment::Outside) continue;
+
+            if (node.isLeaf()) {
+                outVisible.push_back(node.userData);
+            }
+            else if (containment == Containment::Inside) {
+                appendLeaves(index, outVisible);
+            }
+            else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    int32_t DynamicBvh::allocateNode() {
+        if (mFreeList == NULL_NODE) {
+            mNodes.emplace_back();
+            return static_cast<int32_t>(mNodes.size() - 1);
+        }
+
+        int32_t index = mFreeList;
+        mFreeList = mNodes[index].parent;
+        mNodes[index] = Node{};
+        return index;
+    }
+
+    void DynamicBvh::freeNode(int32_t inNode) {
+        mNodes[inNode] = Node{};
+        mNodes[inNode].parent = mFreeList;
+        mFreeList = inNode;
+    }
+
+    void DynamicBvh::insertLeaf(int32_t inLeaf) {
+        if (mRoot == NULL_NODE) {
+            mRoot = inLeaf;
+            mNodes[inLeaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Walk down towards the cheapest sibling by surface area, counting the
+        // growth every ancestor inherits
+        const Aabb leafBox = mNodes[inLeaf].box;
+        int32_t index = mRoot;
+        while (!mNodes[index].isLeaf()) {
+            const auto& node = mNodes[index];
+            float area = surfaceArea(node.box);
+            float combinedArea = surfaceArea(merge(node.box, leafBox));
+
+            // Cost of making a new parent for this node and the leaf
+            float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down
+            float inheritance = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                const auto& childNode = mNodes[child];
+                float mergedArea = surfaceArea(merge(leafBox, childNode.box));
+                return childNode.isLeaf()
+                    ? mergedArea + inheritance
+                    : mergedArea - surfaceArea(childNode.box) + inheritance;
+            };
+            float cost1 = descendCost(node.child1);
+            float cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        int32_t sibling = index;
+        int32_t oldParent = mNodes[sibling].parent;
+        int32_t newParent = allocateNode();
+
+        auto& parentNode = mNodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.box = merge(leafBox, mNodes[sibling].box);
+        parentNode.height = mNodes[sibling].height + 1;
+        parentNode.child1 = sibling;
+        parentNode.child2 = inLeaf;
+
+        if (oldParent != NULL_NODE) {
+            auto& grandParent = mNodes[oldParent];
+            (grandParent.child1 == sibling ? grandParent.child1 : grandParent.child2) = newParent;
+        }
+        else {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[inLeaf].parent = newParent;
+
+        refit(mNodes[inLeaf].parent);
+    }
+
+    void DynamicBvh::removeLeaf(int32_t inLeaf) {
+        if (inLeaf == mRoot) {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int32_t parent = mNodes[inLeaf].parent;
+        int32_t grandParent = mNodes[parent].parent;
+        int32_t sibling = mNodes[parent].child1 == inLeaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        // The sibling takes the parent's place
+        if (grandParent != NULL_NODE) {
+            auto& grandNode = mNodes[grandParent];
+            (grandNode.child1 == parent ? grandNode.child1 : grandNode.child2) = sibling;
+            mNodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refit(grandParent);
+        }
+        else {
+            mRoot = sibling;
+            mNodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+        mNodes[inLeaf].parent = NULL_NODE;
+    }
+
+    void DynamicBvh::refit(int32_t inNode) {
+        for (int32_t index = inNode; index != NULL_NODE; index = mNodes[index].parent) {
+            index = balance(index);
+
+            auto& node = mNodes[index];
+            const auto& child1 = mNodes[node.child1];
+            const auto& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.box = merge(child1.box, child2.box);
+        }
+    }
+
+    int32_t DynamicBvh::balance(int32_t inNode) {
+        int32_t iA = inNode;
+        if (mNodes[iA].isLeaf() || mNodes[iA].height < 2) {
+            return iA;
+        }
+
+        int32_t iB = mNodes[iA].child1;
+        int32_t iC = mNodes[iA].child2;
+        int32_t heightDifference = mNodes[iC].height - mNodes[iB].height;
+
+        // Rotates the taller child up into A's place. A keeps its shorter child
+        // and takes the shorter of the taller child's children.
+        auto rotate = [&](int32_t iUp, int32_t iStay, bool upIsSecond) {
+            auto& A = mNodes[iA];
+            auto& up = mNodes[iUp];
+            int32_t iF = up.child1;
+            int32_t iG = up.child2;
+
+            up.child1 = iA;
+            up.parent = A.parent;
+            A.parent = iUp;
+
+            if (up.parent != NULL_NODE) {
+                auto& parent = mNodes[up.parent];
+                (parent.child1 == iA ? parent.child1 : parent.child2) = iUp;
+            }
+            else {
+                mRoot = iUp;
+            }
+
+            int32_t iTall = mNodes[iF].height > mNodes[iG].height ? iF : iG;
+            int32_t iShort = iTall == iF ? iG : iF;
+
+            up.child2 = iTall;
+            (upIsSecond ? A.child2 : A.child1) = iShort;
+            mNodes[iShort].parent = iA;
+
+            A.box = merge(mNodes[iStay].box, mNodes[iShort].box);
+            A.height = 1 + std::max(mNodes[iStay].height, mNodes[iShort].height);
+            up.box = merge(A.box, mNodes[iTall].box);
+            up.height = 1 + std::max(A.height, mNodes[iTall].height);
+            return iUp;
+        };
+
+        if (heightDifference > 1) {
+            return rotate(iC, iB, true);
+        }
+        if (heightDifference < -1) {
+            return rotate(iB, iC, false);
+        }
+        return iA;
+    }
+
+    void DynamicBvh::appendLeaves(int32_t inRoot, std::vector<uint32_t>& outVisible) const {
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(inRoot);
+        while (!stack.empty()) {
+            const auto& node = mNodes[stack.back()];
+            stack.pop_back();
+
+            if (node.isLeaf()) {
+                outVisible.push_back(node.userData);
+                continue;
+            }
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
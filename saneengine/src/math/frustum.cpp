@@ -0,0 +1,102 @@
+#include "saneengine/math/frustum.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SANE_SIMD_SSE2 1
+#endif
+
+namespace sane::math {
+    Aabb transformAabb(const Aabb& inBox, const glm::mat4& inMatrix) {
+        // Arvo: the extent grows by the absolute value of the rotation and scale
+        glm::vec3 center = (inBox.min + inBox.max) * 0.5f;
+        glm::vec3 extent = (inBox.max - inBox.min) * 0.5f;
+
+        glm::vec3 worldCenter(inMatrix[3].x, inMatrix[3].y, inMatrix[3].z);
+        glm::vec3 worldExtent(0.0f);
+        for (int column = 0; column < 3; ++column) {
+            const glm::vec4& axis = inMatrix[column];
+            worldCenter += glm::vec3(axis.x, axis.y, axis.z) * center[column];
+            worldExtent += glm::vec3(std::abs(axis.x), std::abs(axis.y), std::abs(axis.z)) * extent[column];
+        }
+        return { worldCenter - worldExtent, worldCenter + worldExtent };
+    }
+
+    Frustum::Frustum() {
+        for (uint32_t i = 0; i < PADDED_COUNT; ++i) {
+            mX[i] = 0.0f;
+            mY[i] = 0.0f;
+            mZ[i] = 0.0f;
+            mW[i] = 1.0f;
+        }
+    }
+
+    Frustum::Frustum(const glm::mat4& inViewProjection) {
+        // Gribb/Hartmann: each plane is the w row plus or minus another row
+        auto row = [&](int index) {
+            return glm::vec4(inViewProjection[0][index], inViewProjection[1][index],
+                inViewProjection[2][index], inViewProjection[3][index]);
+        };
+        const glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+        const glm::vec4 planes[PLANE_COUNT] = { w + x, w - x, w + y, w - y, w + z, w - z };
+
+        for (uint32_t i = 0; i < PADDED_COUNT; ++i) {
+            // The padding repeats real planes so it never changes the result
+            const glm::vec4& plane = planes[i % PLANE_COUNT];
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            mX[i] = plane.x * scale;
+            mY[i] = plane.y * scale;
+            mZ[i] = plane.z * scale;
+            mW[i] = plane.w * scale;
+        }
+    }
+
+    Containment Frustum::test(const Aabb& inBox) const {
+        const float cx = (inBox.min.x + inBox.max.x) * 0.5f;
+        const float cy = (inBox.min.y + inBox.max.y) * 0.5f;
+        const float cz = (inBox.min.z + inBox.max.z) * 0.5f;
+        const float ex = (inBox.max.x - inBox.min.x) * 0.5f;
+        const float ey = (inBox.max.y - inBox.min.y) * 0.5f;
+        const float ez = (inBox.max.z - inBox.min.z) * 0.5f;
+
+#if defined(SANE_SIMD_SSE2)
+        const __m128 centerX = _mm_set1_ps(cx), centerY = _mm_set1_ps(cy), centerZ = _mm_set1_ps(cz);
+        const __m128 extentX = _mm_set1_ps(ex), extentY = _mm_set1_ps(ey), extentZ = _mm_set1_ps(ez);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 zero = _mm_setzero_ps();
+
+        int outside = 0;
+        int crossing = 0;
+        for (uint32_t i = 0; i < PADDED_COUNT; i += 4) {
+            const __m128 x = _mm_load_ps(mX + i);
+            const __m128 y = _mm_load_ps(mY + i);
+            const __m128 z = _mm_load_ps(mZ + i);
+
+            // Signed distance of the center and the box's projected radius on each normal
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, centerX), _mm_mul_ps(y, centerY)),
+                _mm_add_ps(_mm_mul_ps(z, centerZ), _mm_load_ps(mW + i)));
+            __m128 radius = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_and_ps(x, absMask), extentX),
+                _mm_mul_ps(_mm_and_ps(y, absMask), extentY)),
+                _mm_mul_ps(_mm_and_ps(z, absMask), extentZ));
+
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+            crossing |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero));
+        }
+
+        if (outside) return Containment::Outside;
+        return crossing ? Containment::Intersects : Containment::Inside;
+#else
+        bool crossing = false;
+        for (uint32_t i = 0; i < PLANE_COUNT; ++i) {
+            float distance = mX[i] * cx + mY[i] * cy + mZ[i] * cz + mW[i];
+            float radius = std::abs(mX[i]) * ex + std::abs(mY[i]) * ey + std::abs(mZ[i]) * ez;
+            if (distance + radius < 0.0f) return Containment::Outside;
+            if (distance - radius < 0.0f) crossing = true;
+        }
+        return crossing ? Containment::Intersects : Containment::Inside;
+#endif
+    }
+}
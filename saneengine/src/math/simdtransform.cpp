@@ -0,0 +1,244 @@
+#include "saneengine/math/simdtransform.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SANE_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SANE_SIMD_SSE2 1
+#endif
+
+namespace {
+    using sane::math::TransformSoA;
+
+    // Column-major model matrix for a single entry, matching
+    // translate * rotateX * rotateY * rotateZ * scale.
+    void composeScalar(const TransformSoA& in, size_t i, float* out) {
+        const float sa = std::sin(in.rotX[i]), ca = std::cos(in.rotX[i]);
+        const float sb = std::sin(in.rotY[i]), cb = std::cos(in.rotY[i]);
+        const float sc = std::sin(in.rotZ[i]), cc = std::cos(in.rotZ[i]);
+        const float sx = in.scaleX[i], sy = in.scaleY[i], sz = in.scaleZ[i];
+
+        out[0] = cb * cc * sx;
+        out[1] = (sa * sb * cc + ca * sc) * sx;
+        out[2] = (sa * sc - ca * sb * cc) * sx;
+        out[3] = 0.0f;
+
+        out[4] = -cb * sc * sy;
+        out[5] = (ca * cc - sa * sb * sc) * sy;
+        out[6] = (ca * sb * sc + sa * cc) * sy;
+        out[7] = 0.0f;
+
+        out[8] = sb * sz;
+        out[9] = -sa * cb * sz;
+        out[10] = ca * cb * sz;
+        out[11] = 0.0f;
+
+        out[12] = in.posX[i];
+        out[13] = in.posY[i];
+        out[14] = in.posZ[i];
+        out[15] = 1.0f;
+    }
+
+#if defined(SANE_SIMD_AVX2) || defined(SANE_SIMD_SSE2)
+    // Instruction set wrappers so the sincos and compose kernels are written once
+#if defined(SANE_SIMD_AVX2)
+    struct Isa {
+        using V = __m256;
+        using I = __m256i;
+        static constexpr size_t WIDTH = 8;
+
+        static V load(const float* p) { return _mm256_loadu_ps(p); }
+        static V set1(float v) { return _mm256_set1_ps(v); }
+        static V zero() { return _mm256_setzero_ps(); }
+        static V add(V a, V b) { return _mm256_add_ps(a, b); }
+        static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static V and_(V a, V b) { return _mm256_and_ps(a, b); }
+        static V andnot(V a, V b) { return _mm256_andnot_ps(a, b); }
+        static V xor_(V a, V b) { return _mm256_xor_ps(a, b); }
+
+        static I toInt(V a) { return _mm256_cvttps_epi32(a); }
+        static V toFloat(I a) { return _mm256_cvtepi32_ps(a); }
+        static I set1i(int32_t v) { return _mm256_set1_epi32(v); }
+        static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+        static I subi(I a, I b) { return _mm256_sub_epi32(a, b); }
+        static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+        static I andnoti(I a, I b) { return _mm256_andnot_si256(a, b); }
+        static I cmpeqi(I a, I b) { return _mm256_cmpeq_epi32(a, b); }
+        static I shift29(I a) { return _mm256_slli_epi32(a, 29); }
+        static V asFloat(I a) { return _mm256_castsi256_ps(a); }
+
+        // Writes one column (x, y, z, w) of eight consecutive matrices
+        static void storeColumn(V x, V y, V z, V w, float* out) {
+            __m256 t0 = _mm256_unpacklo_ps(x, y);
+            __m256 t1 = _mm256_unpackhi_ps(x, y);
+            __m256 t2 = _mm256_unpacklo_ps(z, w);
+            __m256 t3 = _mm256_unpackhi_ps(z, w);
+            __m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            _mm_store_ps(out + 0 * 16, _mm256_castps256_ps128(r0));
+            _mm_store_ps(out + 1 * 16, _mm256_castps256_ps128(r1));
+            _mm_store_ps(out + 2 * 16, _mm256_castps256_ps128(r2));
+            _mm_store_ps(out + 3 * 16, _mm256_castps256_ps128(r3));
+            _mm_store_ps(out + 4 * 16, _mm256_extractf128_ps(r0, 1));
+            _mm_store_ps(out + 5 * 16, _mm256_extractf128_ps(r1, 1));
+            _mm_store_ps(out + 6 * 16, _mm256_extractf128_ps(r2, 1));
+            _mm_store_ps(out + 7 * 16, _mm256_extractf128_ps(r3, 1));
+        }
+    };
+#else
+    struct Isa {
+        using V = __m128;
+        using I = __m128i;
+        static constexpr size_t WIDTH = 4;
+
+        static V load(const float* p) { return _mm_loadu_ps(p); }
+        static V set1(float v) { return _mm_set1_ps(v); }
+        static V zero() { return _mm_setzero_ps(); }
+        static V add(V a, V b) { return _mm_add_ps(a, b); }
+        static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static V and_(V a, V b) { return _mm_and_ps(a, b); }
+        static V andnot(V a, V b) { return _mm_andnot_ps(a, b); }
+        static V xor_(V a, V b) { return _mm_xor_ps(a, b); }
+
+        static I toInt(V a) { return _mm_cvttps_epi32(a); }
+        static V toFloat(I a) { return _mm_cvtepi32_ps(a); }
+        static I set1i(int32_t v) { return _mm_set1_epi32(v); }
+        static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+        static I subi(I a, I b) { return _mm_sub_epi32(a, b); }
+        static I andi(I a, I b) { return _mm_and_si128(a, b); }
+        static I andnoti(I a, I b) { return _mm_andnot_si128(a, b); }
+        static I cmpeqi(I a, I b) { return _mm_cmpeq_epi32(a, b); }
+        static I shift29(I a) { return _mm_slli_epi32(a, 29); }
+        static V asFloat(I a) { return _mm_castsi128_ps(a); }
+
+        // Writes one column (x, y, z, w) of four consecutive matrices
+        static void storeColumn(V x, V y, V z, V w, float* out) {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_store_ps(out + 0 * 16, x);
+            _mm_store_ps(out + 1 * 16, y);
+            _mm_store_ps(out + 2 * 16, z);
+            _mm_store_ps(out + 3 * 16, w);
+        }
+    };
+#endif
+
+    // Cephes style sincos, accurate to ~1e-7 for |x| < 8192
+    void sincos(Isa::V x, Isa::V& outSin, Isa::V& outCos) {
+        const Isa::V signMask = Isa::asFloat(Isa::set1i(int32_t(0x80000000)));
+
+        Isa::V signSin = Isa::and_(x, signMask);
+        x = Isa::andnot(signMask, x);
+
+        Isa::I j = Isa::toInt(Isa::mul(x, Isa::set1(1.27323954473516f)));
+        j = Isa::andi(Isa::addi(j, Isa::set1i(1)), Isa::set1i(~1));
+        Isa::V y = Isa::toFloat(j);
+
+        Isa::V swapSignSin = Isa::asFloat(Isa::shift29(Isa::andi(j, Isa::set1i(4))));
+        Isa::V polyMask = Isa::asFloat(Isa::cmpeqi(Isa::andi(j, Isa::set1i(2)), Isa::set1i(0)));
+        Isa::V signCos = Isa::asFloat(Isa::shift29(Isa::andnoti(Isa::subi(j, Isa::set1i(2)), Isa::set1i(4))));
+        signSin = Isa::xor_(signSin, swapSignSin);
+
+        x = Isa::sub(x, Isa::mul(y, Isa::set1(0.78515625f)));
+        x = Isa::sub(x, Isa::mul(y, Isa::set1(2.4187564849853515625e-4f)));
+        x = Isa::sub(x, Isa::mul(y, Isa::set1(3.77489497744594108e-8f)));
+
+        Isa::V z = Isa::mul(x, x);
+
+        Isa::V c = Isa::set1(2.443315711809948e-5f);
+        c = Isa::add(Isa::mul(c, z), Isa::set1(-1.388731625493765e-3f));
+        c = Isa::add(Isa::mul(c, z), Isa::set1(4.166664568298827e-2f));
+        c = Isa::mul(Isa::mul(c, z), z);
+        c = Isa::sub(c, Isa::mul(z, Isa::set1(0.5f)));
+        c = Isa::add(c, Isa::set1(1.0f));
+
+        Isa::V s = Isa::set1(-1.9515295891e-4f);
+        s = Isa::add(Isa::mul(s, z), Isa::set1(8.3321608736e-3f));
+        s = Isa::add(Isa::mul(s, z), Isa::set1(-1.6666654611e-1f));
+        s = Isa::add(Isa::mul(Isa::mul(s, z), x), x);
+
+        Isa::V sinPoly = Isa::and_(polyMask, s);
+        Isa::V cosPoly = Isa::andnot(polyMask, c);
+        outSin = Isa::xor_(Isa::add(sinPoly, cosPoly), signSin);
+        outCos = Isa::xor_(Isa::add(Isa::sub(c, cosPoly), Isa::sub(s, sinPoly)), signCos);
+    }
+
+    void composeWide(const TransformSoA& in, size_t i, float* out) {
+        Isa::V sa, ca, sb, cb, sc, cc;
+        sincos(Isa::load(in.rotX + i), sa, ca);
+        sincos(Isa::load(in.rotY + i), sb, cb);
+        sincos(Isa::load(in.rotZ + i), sc, cc);
+
+        const Isa::V sx = Isa::load(in.scaleX + i);
+        const Isa::V sy = Isa::load(in.scaleY + i);
+        const Isa::V sz = Isa::load(in.scaleZ + i);
+        const Isa::V zero = Isa::zero();
+
+        const Isa::V sasb = Isa::mul(sa, sb);
+        const Isa::V casb = Isa::mul(ca, sb);
+
+        Isa::storeColumn(
+            Isa::mul(Isa::mul(cb, cc), sx),
+            Isa::mul(Isa::add(Isa::mul(sasb, cc), Isa::mul(ca, sc)), sx),
+            Isa::mul(Isa::sub(Isa::mul(sa, sc), Isa::mul(casb, cc)), sx),
+            zero,
+            out + 0);
+
+        Isa::storeColumn(
+            Isa::mul(Isa::sub(zero, Isa::mul(cb, sc)), sy),
+            Isa::mul(Isa::sub(Isa::mul(ca, cc), Isa::mul(sasb, sc)), sy),
+            Isa::mul(Isa::add(Isa::mul(casb, sc), Isa::mul(sa, cc)), sy),
+            zero,
+            out + 4);
+
+        Isa::storeColumn(
+            Isa::mul(sb, sz),
+            Isa::mul(Isa::sub(zero, Isa::mul(sa, cb)), sz),
+            Isa::mul(Isa::mul(ca, cb), sz),
+            zero,
+            out + 8);
+
+        Isa::storeColumn(
+            Isa::load(in.posX + i),
+            Isa::load(in.posY + i),
+            Isa::load(in.posZ + i),
+            Isa::set1(1.0f),
+            out + 12);
+    }
+#endif
+}
+
+namespace sane::math {
+    void composeModelMatrices(const TransformSoA& inTransforms, size_t first, size_t count, float* outMatrices) {
+        size_t i = first;
+        const size_t last = first + count;
+
+#if defined(SANE_SIMD_AVX2) || defined(SANE_SIMD_SSE2)
+        for (; i + Isa::WIDTH <= last; i += Isa::WIDTH) {
+            composeWide(inTransforms, i, outMatrices + i * 16);
+        }
+#endif
+
+        for (; i < last; ++i) {
+            composeScalar(inTransforms, i, outMatrices + i * 16);
+        }
+    }
+
+    const char* getSimdPath() {
+#if defined(SANE_SIMD_AVX2)
+        return "AVX2";
+#elif defined(SANE_SIMD_SSE2)
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+}
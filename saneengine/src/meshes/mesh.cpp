@@ -0,0 +1,64 @@
+#include "saneengine/gfx/meshes/mesh.hpp"
+
+#include <stdexcept>
+
+namespace sane::gfx {
+
+    Mesh::Mesh(const float* inVertices, uint32_t inVertexCount, const std::vector<VertexAttribute>& inAttributes)
+        : mVertexArray(0)
+        , mVertexCount(inVertexCount)
+    {
+        glGenVertexArrays(1, &mVertexArray);
+        if (!mVertexArray) {
+            throw std::runtime_error("Failed to create vertex array");
+        }
+
+        glBindVertexArray(mVertexArray);
+        mVertexBuffer = std::make_unique<VertexBuffer>(
+            inVertexCount * 3 * static_cast<uint32_t>(sizeof(float)), GL_STATIC_DRAW, inVertices);
+        mVertexBuffer->bind();
+
+        for (const auto& attr : inAttributes) {
+            glEnableVertexAttribArray(attr.position);
+            glVertexAttribPointer(
+                attr.position,
+                attr.count,
+                attr.type,
+                attr.normalized ? GL_TRUE : GL_FALSE,
+                attr.stride,
+                (void*)attr.offset
+            );
+            if (attr.instances) {
+                glVertexAttribDivisor(attr.position, attr.instances);
+            }
+        }
+
+        glBindVertexArray(0);
+        mVertexBuffer->unbind();
+    }
+
+    Mesh::~Mesh() {
+        mVertexBuffer.reset();
+        if (mVertexArray) {
+            glDeleteVertexArrays(1, &mVertexArray);
+            mVertexArray = 0;
+        }
+    }
+
+    void Mesh::bind() const {
+        glBindVertexArray(mVertexArray);
+    }
+
+    void Mesh::unbind() const {
+        glBindVertexArray(0);
+    }
+
+    GLuint Mesh::getVertexArray() const {
+        return mVertexArray;
+    }
+
+    uint32_t Mesh::getVertexCount() const {
+        return mVertexCount;
+    }
+
+} // namespace sane::gfx
@@ -0,0 +1,215 @@
+#include "saneengine/gfx/meshes/meshregistry.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t hashBytes(uint64_t inHash, const void* inData, size_t inSize)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(inData);
+        for (size_t i = 0; i < inSize; ++i)
+        {
+            inHash ^= bytes[i];
+            inHash *= FNV_PRIME;
+        }
+        return inHash;
+    }
+
+    template<typename T>
+    uint64_t hashValue(uint64_t inHash, const T& inValue)
+    {
+        return hashBytes(inHash, &inValue, sizeof(inValue));
+    }
+
+    // Field by field, the struct has padding
+    uint64_t hashAttribute(uint64_t inHash, const sane::gfx::VertexAttribute& inAttribute)
+    {
+        inHash = hashValue(inHash, inAttribute.position);
+        inHash = hashValue(inHash, inAttribute.count);
+        inHash = hashValue(inHash, inAttribute.type);
+        inHash = hashValue(inHash, inAttribute.normalized);
+        inHash = hashValue(inHash, inAttribute.stride);
+        inHash = hashValue(inHash, inAttribute.offset);
+        return hashValue(inHash, inAttribute.instances);
+    }
+
+    bool sameAttribute(const sane::gfx::VertexAttribute& inA, const sane::gfx::VertexAttribute& inB)
+    {
+        return inA.position == inB.position && inA.count == inB.count && inA.type == inB.type
+            && inA.normalized == inB.normalized && inA.stride == inB.stride && inA.offset == inB.offset
+            && inA.instances == inB.instances;
+    }
+}
+
+namespace sane::gfx
+{
+    struct MeshHandle::Entry
+    {
+        MeshData data;
+        std::atomic<uint32_t> references{ 0 };
+        MeshRegistry* registry{ nullptr };
+    };
+
+    class MeshRegistry::Impl
+    {
+    public:
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, std::unique_ptr<MeshHandle::Entry>> entries;
+
+        static bool matches(const MeshData& inData, const float* inVertices, size_t inVertexCount,
+            const std::vector<VertexAttribute>& inAttributes)
+        {
+            return inData.vertexCount == inVertexCount
+                && std::equal(inData.vertices.begin(), inData.vertices.end(), inVertices)
+                && std::equal(inData.attributes.begin(), inData.attributes.end(),
+                    inAttributes.begin(), inAttributes.end(), sameAttribute);
+        }
+    };
+
+    MeshHandle::MeshHandle(const MeshHandle& inOther) : mEntry(inOther.mEntry)
+    {
+        if (mEntry)
+        {
+            mEntry->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    MeshHandle::MeshHandle(MeshHandle&& inOther) noexcept : mEntry(inOther.mEntry)
+    {
+        inOther.mEntry = nullptr;
+    }
+
+    MeshHandle& MeshHandle::operator=(const MeshHandle& inOther)
+    {
+        MeshHandle copy(inOther);
+        std::swap(mEntry, copy.mEntry);
+        return *this;
+    }
+
+    MeshHandle& MeshHandle::operator=(MeshHandle&& inOther) noexcept
+    {
+        if (this != &inOther)
+        {
+            MeshHandle old(std::move(*this));
+            std::swap(mEntry, inOther.mEntry);
+        }
+        return *this;
+    }
+
+    MeshHandle::~MeshHandle()
+    {
+        if (mEntry)
+        {
+            mEntry->registry->release(mEntry);
+        }
+    }
+
+    const MeshData* MeshHandle::get() const
+    {
+        return mEntry ? &mEntry->data : nullptr;
+    }
+
+    MeshRegistry::MeshRegistry() : mImpl(new Impl)
+    {
+    }
+
+    MeshRegistry::~MeshRegistry()
+    {
+        delete mImpl;
+    }
+
+    MeshRegistry& MeshRegistry::get()
+    {
+        static MeshRegistry instance;
+        return instance;
+    }
+
+    MeshHandle MeshRegistry::acquire(const float* inVertices, size_t inVertexCount,
+        const std::vector<VertexAttribute>& inAttributes)
+    {
+        if (!inVertices)
+        {
+            inVertexCount = 0;
+        }
+
+        uint64_t hash = hashBytes(FNV_OFFSET, inVertices, inVertexCount * 3 * sizeof(float));
+        for (const auto& attribute : inAttributes)
+        {
+            hash = hashAttribute(hash, attribute);
+        }
+
+        std::scoped_lock lock(mImpl->mutex);
+        for (;;)
+        {
+            auto it = mImpl->entries.find(hash);
+            if (it == mImpl->entries.end())
+            {
+                break;
+            }
+            if (Impl::matches(it->second->data, inVertices, inVertexCount, inAttributes))
+            {
+                it->second->references.fetch_add(1, std::memory_order_relaxed);
+                return MeshHandle(it->second.get());
+            }
+            // Different geometry under the same hash, the hash identifies GPU meshes so find a free one
+            hash = hashValue(hash, hash);
+        }
+
+        auto entry = std::make_unique<MeshHandle::Entry>();
+        auto& data = entry->data;
+        data.vertices.assign(inVertices, inVertices + inVertexCount * 3);
+        data.vertexCount = inVertexCount;
+        data.attributes = inAttributes;
+        data.hash = hash;
+        data.boundsMin = data.boundsMax = glm::vec3(0.0f);
+        if (inVertexCount > 0)
+        {
+            data.boundsMin = data.boundsMax = glm::vec3(inVertices[0], inVertices[1], inVertices[2]);
+            for (size_t i = 1; i < inVertexCount; ++i)
+            {
+                glm::vec3 position(inVertices[i * 3], inVertices[i * 3 + 1], inVertices[i * 3 + 2]);
+                data.boundsMin = glm::min(data.boundsMin, position);
+                data.boundsMax = glm::max(data.boundsMax, position);
+            }
+        }
+        entry->references.store(1, std::memory_order_relaxed);
+        entry->registry = this;
+
+        MeshHandle handle(entry.get());
+        mImpl->entries.emplace(hash, std::move(entry));
+        return handle;
+    }
+
+    size_t MeshRegistry::size() const
+    {
+        std::scoped_lock lock(mImpl->mutex);
+        return mImpl->entries.size();
+    }
+
+    void MeshRegistry::release(MeshHandle::Entry* inEntry)
+    {
+        // Other references remain: no lock needed, the count cannot reach zero here
+        uint32_t references = inEntry->references.load(std::memory_order_relaxed);
+        while (references > 1)
+        {
+            if (inEntry->references.compare_exchange_weak(references, references - 1,
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+
+        // Possibly the last one. acquire() only revives entries under the lock.
+        std::scoped_lock lock(mImpl->mutex);
+        if (inEntry->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            mImpl->entries.erase(inEntry->data.hash);
+        }
+    }
+} // namespace sane::gfx
@@ -0,0 +1,133 @@
+#include "saneengine/gfx/queries/gputimer.hpp"
+#include "saneengine/utils/timings.hpp"
+#include <glad/glad.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sane::gfx {
+    class GpuTimer::Impl {
+    public:
+        // Marks passes that are not timed so endPass stays balanced
+        static constexpr uint32_t UNTIMED = UINT32_MAX;
+
+        struct Pass {
+            utils::TimingTrack* track;
+        };
+
+        // Queries 2 * i and 2 * i + 1 hold the start and end of pass i
+        struct Frame {
+            GLuint queries[MAX_PASSES * 2]{};
+            Pass passes[MAX_PASSES]{};
+            uint32_t passCount{ 0 };
+        };
+
+        bool supported{ false };
+        Frame frames[FRAME_LATENCY];
+        uint32_t current{ 0 };
+        std::vector<uint32_t> openPasses;
+        std::vector<std::pair<std::string, std::shared_ptr<utils::TimingTrack>>> tracks;
+
+        utils::TimingTrack* getTrack(const char* name) {
+            for (const auto& [trackName, track] : tracks) {
+                if (trackName == name) {
+                    return track.get();
+                }
+            }
+            auto track = utils::Timings::get().addTrack(name, utils::TimingKind::GpuPass);
+            return tracks.emplace_back(name, std::move(track)).second.get();
+        }
+
+        // Records the frame's durations if every query has landed, never waits
+        void collect(Frame& frame) {
+            uint32_t queryCount = frame.passCount * 2;
+            for (uint32_t i = 0; i < queryCount; ++i) {
+                GLint available = 0;
+                glGetQueryObjectiv(frame.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) return;
+            }
+
+            for (uint32_t i = 0; i < frame.passCount; ++i) {
+                GLuint64 start = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+                glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+                if (frame.passes[i].track && end >= start) {
+                    frame.passes[i].track->record(std::chrono::nanoseconds(end - start));
+                }
+            }
+        }
+    };
+
+    GpuTimer::GpuTimer() : mImpl(new Impl) {
+        if constexpr (!utils::TIMINGS_ENABLED) {
+            return;
+        }
+
+        GLint bits = 0;
+        glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+        mImpl->supported = bits > 0;
+        if (!mImpl->supported) return;
+
+        for (auto& frame : mImpl->frames) {
+            glGenQueries(MAX_PASSES * 2, frame.queries);
+        }
+    }
+
+    GpuTimer::~GpuTimer() {
+        if (mImpl->supported) {
+            for (auto& frame : mImpl->frames) {
+                glDeleteQueries(MAX_PASSES * 2, frame.queries);
+            }
+        }
+        for (const auto& [name, track] : mImpl->tracks) {
+            if (track) {
+                utils::Timings::get().removeTrack(track.get());
+            }
+        }
+        delete mImpl;
+    }
+
+    void GpuTimer::beginFrame() {
+        if (!mImpl->supported) return;
+
+        // The frame recorded FRAME_LATENCY frames ago gets reused for this one
+        mImpl->current = (mImpl->current + 1) % FRAME_LATENCY;
+        auto& frame = mImpl->frames[mImpl->current];
+        if (frame.passCount > 0) {
+            mImpl->collect(frame);
+        }
+        frame.passCount = 0;
+        mImpl->openPasses.clear();
+    }
+
+    void GpuTimer::beginPass(const char* name) {
+        auto& frame = mImpl->frames[mImpl->current];
+        if (!mImpl->supported || frame.passCount == MAX_PASSES) {
+            mImpl->openPasses.push_back(Impl::UNTIMED);
+            return;
+        }
+
+        uint32_t index = frame.passCount++;
+        frame.passes[index].track = mImpl->getTrack(name);
+        glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+        mImpl->openPasses.push_back(index);
+    }
+
+    void GpuTimer::endPass() {
+        if (mImpl->openPasses.empty()) return;
+
+        uint32_t index = mImpl->openPasses.back();
+        mImpl->openPasses.pop_back();
+        if (index != Impl::UNTIMED) {
+            glQueryCounter(mImpl->frames[mImpl->current].queries[index * 2 + 1], GL_TIMESTAMP);
+        }
+    }
+
+    bool GpuTimer::isSupported() const {
+        return mImpl->supported;
+    }
+}
@@ -1,7 +1,13 @@
 #include "saneengine/gfx/shaders/shaderprogram.hpp"
+#include "saneengine/gfx/buffers/uniformblocks.hpp"
 
 #include <glad/glad.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 namespace {
@@ -25,10 +31,61 @@ namespace {
 }
 
 namespace sane::gfx {
+    namespace {
+        // Programs live and die on the GL thread, so neither needs a lock
+        std::unordered_map<uint32_t, ShaderProgram*> sPrograms;
+        // Mirrors GL_CURRENT_PROGRAM without asking the driver
+        thread_local uint32_t tBoundProgram = 0;
+        uint64_t sNextSerial = 1;
+    }
+
     class ShaderProgram::Impl {
     public:
         uint32_t program{ 0 };
+        uint64_t serial{ 0 };
         std::string name;
+        std::unique_ptr<ShaderReflection> reflection;
+
+        // Last value written through each uniform slot, for the redundant-set filter
+        std::vector<uint32_t> cacheOffsets;
+        std::vector<uint32_t> cacheSizes;
+        std::vector<uint32_t> cacheWritten;
+        std::vector<uint8_t> cache;
+
+        void buildValueCache() {
+            for (const auto& uniform : reflection->getUniforms()) {
+                auto size = ShaderReflection::getTypeSize(uniform.type) * static_cast<uint32_t>(uniform.arraySize);
+                cacheOffsets.push_back(static_cast<uint32_t>(cache.size()));
+                cacheSizes.push_back(size);
+                cacheWritten.push_back(0);
+                cache.resize(cache.size() + size);
+            }
+        }
+
+        // For writes that bypass the cache
+        void forget(UniformHandle inUniform) {
+            if (inUniform.slot < cacheWritten.size()) {
+                cacheWritten[inUniform.slot] = 0;
+            }
+        }
+
+        // Returns false when the uniform already holds exactly these bytes
+        bool changed(UniformHandle inUniform, const void* inData, size_t inSize) {
+            // Setters write to the bound program, the cache only describes this one
+            assert(tBoundProgram == program && "ShaderProgram must be bound before setting uniforms");
+            if (inUniform.slot >= cacheOffsets.size() || inSize > cacheSizes[inUniform.slot]) {
+                return true;
+            }
+
+            auto* cached = cache.data() + cacheOffsets[inUniform.slot];
+            if (inSize <= cacheWritten[inUniform.slot] && std::memcmp(cached, inData, inSize) == 0) {
+                return false;
+            }
+
+            std::memcpy(cached, inData, inSize);
+            cacheWritten[inUniform.slot] = std::max(cacheWritten[inUniform.slot], static_cast<uint32_t>(inSize));
+            return true;
+        }
     };
 
     ShaderProgram::ShaderProgram(std::initializer_list<ShaderData> inShaderData, const std::string& inName)
@@ -58,65 +115,175 @@ namespace sane::gfx {
         for (auto shader : shaders) {
             glDeleteShader(shader);
         }
+
+        mImpl->reflection = std::make_unique<ShaderReflection>(mImpl->program);
+        mImpl->buildValueCache();
+        bindEngineUniformBlocks(*mImpl->reflection);
+        mImpl->serial = sNextSerial++;
+        sPrograms[mImpl->program] = this;
+    }
+
+    ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
+        : mImpl(other.mImpl)
+    {
+        other.mImpl = nullptr;
+        if (mImpl) {
+            sPrograms[mImpl->program] = this;
+        }
     }
 
     ShaderProgram::~ShaderProgram() {
         if (mImpl) {
+            sPrograms.erase(mImpl->program);
+            if (tBoundProgram == mImpl->program) {
+                tBoundProgram = 0;
+            }
             glDeleteProgram(mImpl->program);
             delete mImpl;
         }
     }
 
+    ShaderProgram* ShaderProgram::find(uint32_t inProgramId) {
+        auto it = sPrograms.find(inProgramId);
+        return it != sPrograms.end() ? it->second : nullptr;
+    }
+
+    void ShaderProgram::use(uint32_t inProgramId) {
+        glUseProgram(inProgramId);
+        tBoundProgram = inProgramId;
+    }
+
     uint32_t ShaderProgram::getProgramId() const {
         return mImpl->program;
     }
 
+    uint64_t ShaderProgram::getSerial() const {
+        return mImpl->serial;
+    }
+
     void ShaderProgram::bind() const {
-        glUseProgram(mImpl->program);
+        use(mImpl->program);
     }
 
     void ShaderProgram::unbind() const {
-        glUseProgram(0);
+        use(0);
     }
 
     int32_t ShaderProgram::getAttribLocation(const char* inAttrib) const {
-        return glGetAttribLocation(mImpl->program, inAttrib);
+        return mImpl->reflection->getAttribLocation(inAttrib);
     }
 
     int32_t ShaderProgram::getUniformLocation(const char* inUniform) const {
-        return glGetUniformLocation(mImpl->program, inUniform);
+        return getUniformHandle(inUniform).location;
+    }
+
+    const ShaderReflection& ShaderProgram::getReflection() const {
+        return *mImpl->reflection;
+    }
+
+    UniformHandle ShaderProgram::getUniformHandle(const char* inUniform) const {
+        auto handle = mImpl->reflection->getUniformHandle(inUniform);
+        if (!handle.isValid() && !mImpl->reflection->findUniform(inUniform)) {
+            // Element names such as "lights[2]" are not in the table, ask the driver
+            handle.location = glGetUniformLocation(mImpl->program, inUniform);
+        }
+        return handle;
     }
 
     void ShaderProgram::setUniform(const char* inUniform, int inValue) {
-        glUniform1i(getUniformLocation(inUniform), inValue);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform1i(handle.location, inValue);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, int inCount, int* inData) {
-        glUniform1iv(getUniformLocation(inUniform), inCount, inData);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform1iv(handle.location, inCount, inData);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, unsigned int inValue) {
-        glUniform1ui(getUniformLocation(inUniform), inValue);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform1ui(handle.location, inValue);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, float inValue) {
-        glUniform1f(getUniformLocation(inUniform), inValue);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform1f(handle.location, inValue);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, const glm::vec2& inValue) {
-        glUniform2fv(getUniformLocation(inUniform), 1, &inValue[0]);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform2fv(handle.location, 1, &inValue[0]);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, const glm::vec3& inValue) {
-        glUniform3fv(getUniformLocation(inUniform), 1, &inValue[0]);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform3fv(handle.location, 1, &inValue[0]);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, const glm::vec4& inValue) {
-        glUniform4fv(getUniformLocation(inUniform), 1, &inValue[0]);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniform4fv(handle.location, 1, &inValue[0]);
     }
 
     void ShaderProgram::setUniform(const char* inUniform, const glm::mat4& inValue) {
-        glUniformMatrix4fv(getUniformLocation(inUniform), 1, GL_FALSE, &inValue[0][0]);
+        auto handle = getUniformHandle(inUniform);
+        mImpl->forget(handle);
+        glUniformMatrix4fv(handle.location, 1, GL_FALSE, &inValue[0][0]);
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, int inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue, sizeof(inValue))) {
+            glUniform1i(inUniform.location, inValue);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, int inCount, int* inData) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, inData, inCount * sizeof(int))) {
+            glUniform1iv(inUniform.location, inCount, inData);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, unsigned int inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue, sizeof(inValue))) {
+            glUniform1ui(inUniform.location, inValue);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, float inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue, sizeof(inValue))) {
+            glUniform1f(inUniform.location, inValue);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, const glm::vec2& inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue[0], sizeof(inValue))) {
+            glUniform2fv(inUniform.location, 1, &inValue[0]);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, const glm::vec3& inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue[0], sizeof(inValue))) {
+            glUniform3fv(inUniform.location, 1, &inValue[0]);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, const glm::vec4& inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue[0], sizeof(inValue))) {
+            glUniform4fv(inUniform.location, 1, &inValue[0]);
+        }
+    }
+
+    void ShaderProgram::setUniform(UniformHandle inUniform, const glm::mat4& inValue) {
+        if (inUniform.isValid() && mImpl->changed(inUniform, &inValue[0][0], sizeof(inValue))) {
+            glUniformMatrix4fv(inUniform.location, 1, GL_FALSE, &inValue[0][0]);
+        }
     }
 
 } // namespace sane::gfx
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "saneengine/gfx/shaders/shaderreflection.hpp"
+
+#include <glad/glad.h>
+#include <unordered_map>
+
+namespace {
+    // "lights[0]" is also reachable as "lights"
+    std::string_view stripArraySuffix(std::string_view inName) {
+        if (inName.size() > 3 && inName.substr(inName.size() - 3) == "[0]") {
+            return inName.substr(0, inName.size() - 3);
+        }
+        return inName;
+    }
+}
+
+namespace sane::gfx {
+    class ShaderReflection::Impl {
+    public:
+        uint32_t program{ 0 };
+
+        // Vectors are reserved up front so the names the lookup tables view never move
+        std::vector<UniformInfo> uniforms;
+        std::vector<AttributeInfo> attributes;
+        std::vector<UniformBlockInfo> blocks;
+
+        std::unordered_map<std::string_view, uint32_t> uniformLookup;
+        std::unordered_map<std::string_view, uint32_t> attributeLookup;
+        std::unordered_map<std::string_view, uint32_t> blockLookup;
+
+        void readUniforms() {
+            GLint count = 0, maxLength = 0;
+            glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+            std::vector<char> name(maxLength + 1);
+            uniforms.reserve(count);
+            for (GLuint i = 0; i < (GLuint)count; ++i) {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(program, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+                GLint blockIndex = -1, blockOffset = -1;
+                glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+                glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_OFFSET, &blockOffset);
+
+                uniforms.push_back({ std::string(name.data(), length), -1, type, size, blockIndex, blockOffset });
+                auto& uniform = uniforms.back();
+                if (blockIndex < 0) {
+                    uniform.location = glGetUniformLocation(program, uniform.name.c_str());
+                }
+
+                auto index = static_cast<uint32_t>(uniforms.size() - 1);
+                uniformLookup.emplace(uniform.name, index);
+                uniformLookup.emplace(stripArraySuffix(uniform.name), index);
+            }
+        }
+
+        void readAttributes() {
+            GLint count = 0, maxLength = 0;
+            glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+            glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+
+            std::vector<char> name(maxLength + 1);
+            attributes.reserve(count);
+            for (GLuint i = 0; i < (GLuint)count; ++i) {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveAttrib(program, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+                attributes.push_back({ std::string(name.data(), length), -1, type, size });
+                auto& attribute = attributes.back();
+                attribute.location = glGetAttribLocation(program, attribute.name.c_str());
+                attributeLookup.emplace(attribute.name, static_cast<uint32_t>(attributes.size() - 1));
+            }
+        }
+
+        void readUniformBlocks() {
+            GLint count = 0, maxLength = 0;
+            glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+            glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+
+            std::vector<char> name(maxLength + 1);
+            blocks.reserve(count);
+            for (GLuint i = 0; i < (GLuint)count; ++i) {
+                GLsizei length = 0;
+                glGetActiveUniformBlockName(program, i, (GLsizei)name.size(), &length, name.data());
+
+                GLint dataSize = 0, binding = 0;
+                glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+                glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING, &binding);
+
+                blocks.push_back({ std::string(name.data(), length), i, dataSize, binding });
+                blockLookup.emplace(blocks.back().name, static_cast<uint32_t>(blocks.size() - 1));
+            }
+        }
+    };
+
+    ShaderReflection::ShaderReflection(uint32_t inProgram)
+        : mImpl(new Impl)
+    {
+        mImpl->program = inProgram;
+        mImpl->readUniforms();
+        mImpl->readAttributes();
+        mImpl->readUniformBlocks();
+    }
+
+    ShaderReflection::ShaderReflection(ShaderReflection&& other) noexcept
+        : mImpl(other.mImpl)
+    {
+        other.mImpl = nullptr;
+    }
+
+    ShaderReflection::~ShaderReflection() {
+        delete mImpl;
+    }
+
+    uint32_t ShaderReflection::getProgramId() const {
+        return mImpl->program;
+    }
+
+    const UniformInfo* ShaderReflection::findUniform(std::string_view inName) const {
+        auto it = mImpl->uniformLookup.find(inName);
+        return it != mImpl->uniformLookup.end() ? &mImpl->uniforms[it->second] : nullptr;
+    }
+
+    const AttributeInfo* ShaderReflection::findAttribute(std::string_view inName) const {
+        auto it = mImpl->attributeLookup.find(inName);
+        return it != mImpl->attributeLookup.end() ? &mImpl->attributes[it->second] : nullptr;
+    }
+
+    const UniformBlockInfo* ShaderReflection::findUniformBlock(std::string_view inName) const {
+        auto it = mImpl->blockLookup.find(inName);
+        return it != mImpl->blockLookup.end() ? &mImpl->blocks[it->second] : nullptr;
+    }
+
+    UniformHandle ShaderReflection::getUniformHandle(std::string_view inName) const {
+        auto it = mImpl->uniformLookup.find(inName);
+        if (it == mImpl->uniformLookup.end()) {
+            return {};
+        }
+        return { mImpl->uniforms[it->second].location, it->second };
+    }
+
+    int32_t ShaderReflection::getUniformLocation(std::string_view inName) const {
+        const auto* uniform = findUniform(inName);
+        return uniform ? uniform->location : -1;
+    }
+
+    int32_t ShaderReflection::getAttribLocation(std::string_view inName) const {
+        const auto* attribute = findAttribute(inName);
+        return attribute ? attribute->location : -1;
+    }
+
+    const std::vector<UniformInfo>& ShaderReflection::getUniforms() const {
+        return mImpl->uniforms;
+    }
+
+    const std::vector<AttributeInfo>& ShaderReflection::getAttributes() const {
+        return mImpl->attributes;
+    }
+
+    const std::vector<UniformBlockInfo>& ShaderReflection::getUniformBlocks() const {
+        return mImpl->blocks;
+    }
+
+    uint32_t ShaderReflection::getTypeSize(uint32_t inType) {
+        switch (inType) {
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+            return 8;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4:
+        case GL_FLOAT_MAT2:
+            return 16;
+        case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2:
+            return 24;
+        case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2:
+            return 32;
+        case GL_FLOAT_MAT3:
+            return 36;
+        case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3:
+            return 48;
+        case GL_FLOAT_MAT4:
+            return 64;
+        default:
+            // Scalars, booleans and samplers
+            return 4;
+        }
+    }
+} // namespace sane::gfx
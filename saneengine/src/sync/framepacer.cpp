@@ -0,0 +1,96 @@
+#include "saneengine/gfx/sync/framepacer.hpp"
+#include "saneengine/utils/profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <thread>
+
+namespace sane::gfx {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // Sleeps end this long before the deadline, the rest is spun
+        constexpr auto SPIN_MARGIN = std::chrono::milliseconds(2);
+        // Bounds the wait on a hung GPU or a lost context
+        constexpr GLuint64 FENCE_TIMEOUT = 1'000'000'000;
+    }
+
+    class FramePacer::Impl {
+    public:
+        Clock::duration targetFrameTime{ Clock::duration::zero() };
+        Clock::time_point deadline{};
+        uint32_t maxQueuedFrames{ 0 };
+        // Oldest frame first
+        std::deque<GLsync> fences;
+
+        void releaseFences() {
+            for (auto fence : fences) {
+                glDeleteSync(fence);
+            }
+            fences.clear();
+        }
+
+        void waitForGpu() {
+            if (maxQueuedFrames == 0) {
+                releaseFences();
+                return;
+            }
+
+            if (auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)) {
+                fences.push_back(fence);
+            }
+            while (fences.size() > maxQueuedFrames) {
+                SANE_PROFILE_SCOPE("FramePacer::waitForGpu");
+                glClientWaitSync(fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+                glDeleteSync(fences.front());
+                fences.pop_front();
+            }
+        }
+
+        void limit() {
+            if (targetFrameTime == Clock::duration::zero()) return;
+
+            auto now = Clock::now();
+            deadline += targetFrameTime;
+            // A frame late by less than the target is caught up on, after a
+            // longer hitch (or on the first frame) pacing starts over from now
+            if (now >= deadline) {
+                if (now - deadline > targetFrameTime) {
+                    deadline = now;
+                }
+                return;
+            }
+
+            SANE_PROFILE_SCOPE("FramePacer::limit");
+            if (deadline - now > SPIN_MARGIN) {
+                std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+            }
+            while (Clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    FramePacer::FramePacer() : mImpl(new Impl) {}
+
+    FramePacer::~FramePacer() {
+        mImpl->releaseFences();
+        delete mImpl;
+    }
+
+    void FramePacer::setTargetFrameTime(float seconds) {
+        mImpl->targetFrameTime = seconds > 0.0f
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(seconds))
+            : Clock::duration::zero();
+    }
+
+    void FramePacer::setMaxQueuedFrames(uint32_t frames) {
+        mImpl->maxQueuedFrames = std::min(frames, MAX_QUEUED_FRAMES);
+    }
+
+    void FramePacer::endFrame() {
+        mImpl->waitForGpu();
+        mImpl->limit();
+    }
+}
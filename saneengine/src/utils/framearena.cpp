@@ -0,0 +1,123 @@
+#include "saneengine/utils/framearena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sane::utils {
+    class FrameArena::Impl {
+    public:
+        struct Block {
+            std::unique_ptr<std::byte[]> memory;
+            size_t size;
+        };
+
+        explicit Impl(size_t inBlockSize) : blockSize(std::max<size_t>(inBlockSize, 1)) {}
+
+        void addBlock(size_t size) {
+            blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+            capacity += size;
+        }
+
+        size_t blockSize;
+        std::vector<Block> blocks;
+        size_t capacity{ 0 };
+
+        // Allocation point: block index and offset within it
+        size_t current{ 0 };
+        size_t offset{ 0 };
+
+        size_t usage{ 0 };
+        size_t peak{ 0 };
+        std::atomic<size_t> lastFramePeak{ 0 };
+    };
+
+    FrameArena::FrameArena(size_t blockSize) : mImpl(new Impl(blockSize)) {
+    }
+
+    FrameArena::~FrameArena() {
+        delete mImpl;
+    }
+
+    FrameArena& FrameArena::get() {
+        static thread_local FrameArena arena;
+        return arena;
+    }
+
+    size_t FrameArena::reset() {
+        size_t framePeak = mImpl->peak;
+
+        // One block that fits the whole frame keeps allocation on the fast path next time
+        if (mImpl->blocks.size() > 1) {
+            size_t total = mImpl->capacity;
+            mImpl->blocks.clear();
+            mImpl->capacity = 0;
+            mImpl->addBlock(total);
+        }
+
+        mImpl->current = 0;
+        mImpl->offset = 0;
+        mImpl->usage = 0;
+        mImpl->peak = 0;
+        mImpl->lastFramePeak.store(framePeak, std::memory_order_relaxed);
+        return framePeak;
+    }
+
+    size_t FrameArena::getUsage() const {
+        return mImpl->usage;
+    }
+
+    size_t FrameArena::getLastFramePeak() const {
+        return mImpl->lastFramePeak.load(std::memory_order_relaxed);
+    }
+
+    size_t FrameArena::getCapacity() const {
+        return mImpl->capacity;
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+        auto& impl = *mImpl;
+        for (;;) {
+            if (impl.current == impl.blocks.size()) {
+                impl.addBlock(std::max(impl.blockSize, bytes + alignment));
+            }
+
+            auto& block = impl.blocks[impl.current];
+            auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+            size_t aligned = ((base + impl.offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+            if (aligned + bytes <= block.size) {
+                impl.usage += aligned + bytes - impl.offset;
+                impl.offset = aligned + bytes;
+                impl.peak = std::max(impl.peak, impl.usage);
+                return block.memory.get() + aligned;
+            }
+
+            // The rest of this block is skipped for the frame
+            impl.usage += block.size - impl.offset;
+            ++impl.current;
+            impl.offset = 0;
+        }
+    }
+
+    void FrameArena::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    }
+
+    bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    FrameArena::Scope::Scope(FrameArena& arena)
+        : mArena(arena)
+        , mBlock(arena.mImpl->current)
+        , mOffset(arena.mImpl->offset)
+        , mUsage(arena.mImpl->usage)
+    {
+    }
+
+    FrameArena::Scope::~Scope() {
+        mArena.mImpl->current = mBlock;
+        mArena.mImpl->offset = mOffset;
+        mArena.mImpl->usage = mUsage;
+    }
+}
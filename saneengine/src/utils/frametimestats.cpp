@@ -0,0 +1,230 @@
+#include "saneengine/utils/frametimestats.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace sane::utils {
+    namespace {
+        // Buckets hold microseconds. Below SUB_BUCKETS each value has its own,
+        // above that every power of two is split into SUB_BUCKETS.
+        constexpr uint32_t SUB_BUCKET_BITS = 4;
+        constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+        // Up to 2^24 us, about 16.7 s; longer frames count as that
+        constexpr uint32_t MAX_EXPONENT = 23;
+        constexpr uint32_t MAX_MICROSECONDS = (1u << (MAX_EXPONENT + 1)) - 1;
+        constexpr uint32_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+        constexpr uint32_t SLICES = 10;
+
+        // Published values per window: frame count, average, median, p99, p99.9, max
+        constexpr size_t FIELD_COUNT = 6;
+
+        uint32_t toMicroseconds(float seconds) {
+            if (!(seconds > 0.0f)) return 0;
+            return static_cast<uint32_t>(std::min(seconds * 1e6f, static_cast<float>(MAX_MICROSECONDS)));
+        }
+
+        uint32_t getBucket(uint32_t microseconds) {
+            if (microseconds < SUB_BUCKETS) return microseconds;
+            uint32_t exponent = std::bit_width(microseconds) - 1;
+            uint32_t subBucket = (microseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+            return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+        }
+
+        float getBucketMidpoint(uint32_t bucket) {
+            if (bucket < SUB_BUCKETS) return static_cast<float>(bucket);
+            uint32_t shift = bucket / SUB_BUCKETS - 1;
+            uint32_t lower = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+            return lower + (1u << shift) * 0.5f;
+        }
+    }
+
+    class FrameTimeStats::Impl {
+    public:
+        struct Slice {
+            std::array<uint32_t, BUCKET_COUNT> counts{};
+            uint32_t frames{ 0 };
+            uint64_t sum{ 0 };
+            uint32_t max{ 0 };
+        };
+
+        // Totals are kept up to date on add, so expiring a slice subtracts it
+        struct Window {
+            float length{ 0.0f };
+            Clock::duration sliceLength{};
+            std::array<Slice, SLICES> slices;
+            std::array<uint32_t, BUCKET_COUNT> totals{};
+            uint32_t frames{ 0 };
+            uint64_t sum{ 0 };
+            uint32_t current{ 0 };
+            Clock::time_point sliceEnd{};
+            bool started{ false };
+
+            void reset(Clock::time_point now) {
+                for (auto& slice : slices) {
+                    slice = Slice{};
+                }
+                totals.fill(0);
+                frames = 0;
+                sum = 0;
+                sliceEnd = now + sliceLength;
+                started = true;
+            }
+
+            void advance(Clock::time_point now) {
+                if (!started || now - sliceEnd >= sliceLength * SLICES) {
+                    reset(now);
+                    return;
+                }
+                while (now >= sliceEnd) {
+                    current = (current + 1) % SLICES;
+                    auto& slice = slices[current];
+                    if (slice.frames > 0) {
+                        for (uint32_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+                            totals[bucket] -= slice.counts[bucket];
+                        }
+                        frames -= slice.frames;
+                        sum -= slice.sum;
+                        slice = Slice{};
+                    }
+                    sliceEnd += sliceLength;
+                }
+            }
+
+            // Upper value below which permille / 1000 of the frames fall
+            uint32_t getPercentile(uint32_t permille, uint32_t max) const {
+                uint64_t target = std::max<uint64_t>((uint64_t{ frames } * permille + 999) / 1000, 1);
+                uint64_t seen = 0;
+                for (uint32_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+                    seen += totals[bucket];
+                    if (seen >= target) {
+                        return std::min(static_cast<uint32_t>(getBucketMidpoint(bucket)), max);
+                    }
+                }
+                return max;
+            }
+
+            FrameTimeSnapshot compute() const {
+                FrameTimeSnapshot snapshot;
+                if (frames == 0) return snapshot;
+
+                uint32_t max = 0;
+                for (const auto& slice : slices) {
+                    max = std::max(max, slice.max);
+                }
+                snapshot.frameCount = frames;
+                snapshot.average = static_cast<float>(sum / 1e6 / frames);
+                snapshot.median = getPercentile(500, max) / 1e6f;
+                snapshot.p99 = getPercentile(990, max) / 1e6f;
+                snapshot.p999 = getPercentile(999, max) / 1e6f;
+                snapshot.max = max / 1e6f;
+                return snapshot;
+            }
+        };
+
+        std::vector<Window> windows;
+
+        // Seqlock over the published fields: odd while publish() writes them
+        std::atomic<uint32_t> sequence{ 0 };
+        std::unique_ptr<std::atomic<float>[]> published;
+    };
+
+    FrameTimeStats::FrameTimeStats(std::initializer_list<float> windows) : mImpl(new Impl) {
+        mImpl->windows.resize(windows.size());
+        size_t index = 0;
+        for (float length : windows) {
+            if (!(length > 0.0f)) {
+                delete mImpl;
+                throw std::runtime_error("Frame time window must be longer than zero");
+            }
+            auto& window = mImpl->windows[index++];
+            window.length = length;
+            window.sliceLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(length / SLICES));
+        }
+
+        mImpl->published.reset(new std::atomic<float>[windows.size() * FIELD_COUNT]);
+        for (size_t i = 0; i < windows.size() * FIELD_COUNT; ++i) {
+            mImpl->published[i].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    FrameTimeStats::~FrameTimeStats() {
+        delete mImpl;
+    }
+
+    void FrameTimeStats::add(float frameTime, Clock::time_point now) {
+        uint32_t microseconds = toMicroseconds(frameTime);
+        uint32_t bucket = getBucket(microseconds);
+        for (auto& window : mImpl->windows) {
+            window.advance(now);
+            auto& slice = window.slices[window.current];
+            ++slice.counts[bucket];
+            ++slice.frames;
+            slice.sum += microseconds;
+            slice.max = std::max(slice.max, microseconds);
+            ++window.totals[bucket];
+            ++window.frames;
+            window.sum += microseconds;
+        }
+    }
+
+    void FrameTimeStats::publish(Clock::time_point now) {
+        uint32_t sequence = mImpl->sequence.load(std::memory_order_relaxed);
+        mImpl->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < mImpl->windows.size(); ++i) {
+            auto& window = mImpl->windows[i];
+            window.advance(now);
+            auto snapshot = window.compute();
+            const float fields[FIELD_COUNT] = { static_cast<float>(snapshot.frameCount), snapshot.average,
+                snapshot.median, snapshot.p99, snapshot.p999, snapshot.max };
+            for (size_t field = 0; field < FIELD_COUNT; ++field) {
+                mImpl->published[i * FIELD_COUNT + field].store(fields[field], std::memory_order_relaxed);
+            }
+        }
+
+        mImpl->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    size_t FrameTimeStats::getWindowCount() const {
+        return mImpl->windows.size();
+    }
+
+    float FrameTimeStats::getWindowLength(size_t window) const {
+        return mImpl->windows.at(window).length;
+    }
+
+    FrameTimeSnapshot FrameTimeStats::getSnapshot(size_t window) const {
+        if (window >= mImpl->windows.size()) {
+            throw std::runtime_error("Frame time window out of range");
+        }
+
+        float fields[FIELD_COUNT];
+        for (;;) {
+            uint32_t before = mImpl->sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t field = 0; field < FIELD_COUNT; ++field) {
+                fields[field] = mImpl->published[window * FIELD_COUNT + field].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (mImpl->sequence.load(std::memory_order_relaxed) == before) break;
+        }
+
+        FrameTimeSnapshot snapshot;
+        snapshot.frameCount = static_cast<uint32_t>(fields[0]);
+        snapshot.average = fields[1];
+        snapshot.median = fields[2];
+        snapshot.p99 = fields[3];
+        snapshot.p999 = fields[4];
+        snapshot.max = fields[5];
+        return snapshot;
+    }
+}
@@ -0,0 +1,157 @@
+#include "saneengine/utils/profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace sane::utils {
+    class Profiler::Impl {
+    public:
+        // Events per thread and capture, later ones are dropped
+        static constexpr uint32_t CAPACITY = 1u << 16;
+
+        struct Event {
+            const char* name;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        // Written only by its thread. A buffer from an older capture is reset
+        // by its thread on the next record, so the reader never races a reset.
+        struct ThreadBuffer {
+            std::string name;
+            uint32_t id{ 0 };
+            std::atomic<uint32_t> generation{ 0 };
+            std::atomic<uint32_t> count{ 0 };
+            std::unique_ptr<Event[]> events;
+        };
+
+        static inline thread_local ThreadBuffer* tBuffer{ nullptr };
+
+        // Guards the buffer list and thread names
+        std::mutex mutex;
+        // Buffers outlive their threads so a capture can still be written
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+        std::mutex captureMutex;
+        std::atomic<uint32_t> generation{ 0 };
+        std::atomic<uint32_t> dropped{ 0 };
+        std::chrono::steady_clock::time_point captureStart;
+
+        ThreadBuffer& getBuffer() {
+            if (!tBuffer) {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto& buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>());
+                buffer->id = static_cast<uint32_t>(buffers.size());
+                buffer->name = "Thread " + std::to_string(buffer->id);
+                tBuffer = buffer.get();
+            }
+            return *tBuffer;
+        }
+
+        static void writeEscaped(std::ofstream& out, const char* text) {
+            for (; *text; ++text) {
+                if (*text == '"' || *text == '\\') out << '\\';
+                if (static_cast<unsigned char>(*text) >= 0x20) out << *text;
+            }
+        }
+    };
+
+    Profiler::Profiler() : mImpl(new Impl) {}
+
+    Profiler::~Profiler() {
+        delete mImpl;
+    }
+
+    Profiler& Profiler::get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    void Profiler::setThreadName(std::string name) {
+        auto& buffer = mImpl->getBuffer();
+        std::lock_guard<std::mutex> lock(mImpl->mutex);
+        buffer.name = std::move(name);
+    }
+
+    void Profiler::beginCapture() {
+        std::lock_guard<std::mutex> lock(mImpl->captureMutex);
+        if (mCapturing.load(std::memory_order_relaxed)) return;
+
+        mImpl->captureStart = std::chrono::steady_clock::now();
+        mImpl->dropped.store(0, std::memory_order_relaxed);
+        mImpl->generation.fetch_add(1, std::memory_order_release);
+        mCapturing.store(true, std::memory_order_release);
+    }
+
+    void Profiler::record(const char* name, std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end)
+    {
+        auto& buffer = mImpl->getBuffer();
+        uint32_t generation = mImpl->generation.load(std::memory_order_acquire);
+        if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+            if (!buffer.events) {
+                buffer.events.reset(new Impl::Event[Impl::CAPACITY]);
+            }
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.generation.store(generation, std::memory_order_release);
+        }
+
+        uint32_t index = buffer.count.load(std::memory_order_relaxed);
+        if (index == Impl::CAPACITY) {
+            mImpl->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.events[index] = { name, start, end };
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    size_t Profiler::endCapture(const char* path) {
+        std::lock_guard<std::mutex> captureLock(mImpl->captureMutex);
+        mCapturing.store(false, std::memory_order_relaxed);
+
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error(std::string("Failed to open trace file: ") + path);
+        }
+
+        uint32_t generation = mImpl->generation.load(std::memory_order_relaxed);
+        auto toMicroseconds = [start = mImpl->captureStart](std::chrono::steady_clock::time_point time) {
+            return std::max(0.0, std::chrono::duration<double, std::micro>(time - start).count());
+        };
+
+        size_t written = 0;
+        char number[128];
+        out << "{\"traceEvents\":[";
+        std::lock_guard<std::mutex> lock(mImpl->mutex);
+        for (const auto& buffer : mImpl->buffers) {
+            out << (buffer->id == 1 ? "\n" : ",\n");
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+            Impl::writeEscaped(out, buffer->name.c_str());
+            out << "\"}}";
+
+            // Only events below count are complete, a thread may still be writing the next one
+            if (buffer->generation.load(std::memory_order_acquire) != generation) continue;
+            uint32_t count = buffer->count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; ++i) {
+                const auto& event = buffer->events[i];
+                out << ",\n{\"name\":\"";
+                Impl::writeEscaped(out, event.name);
+                std::snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->id, toMicroseconds(event.start), toMicroseconds(event.end) - toMicroseconds(event.start));
+                out << number;
+                ++written;
+            }
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":"
+            << mImpl->dropped.load(std::memory_order_relaxed) << "}}\n";
+
+        if (!out) {
+            throw std::runtime_error(std::string("Failed to write trace file: ") + path);
+        }
+        return written;
+    }
+}
@@ -0,0 +1,49 @@
+#include "saneengine/utils/radixsort.hpp"
+
+#include <algorithm>
+
+namespace {
+    constexpr uint32_t PASSES = 8;
+    constexpr uint32_t BUCKETS = 256;
+}
+
+namespace sane::utils {
+    void radixSort(std::vector<SortItem>& ioItems, std::vector<SortItem>& ioScratch) {
+        const size_t count = ioItems.size();
+        if (count < 2) return;
+
+        // One read of the keys builds the histograms of all eight passes
+        uint32_t histograms[PASSES][BUCKETS] = {};
+        for (const auto& item : ioItems) {
+            for (uint32_t pass = 0; pass < PASSES; ++pass) {
+                ++histograms[pass][(item.key >> (pass * 8)) & 0xFF];
+            }
+        }
+
+        ioScratch.resize(count);
+        auto* source = &ioItems;
+        auto* destination = &ioScratch;
+
+        for (uint32_t pass = 0; pass < PASSES; ++pass) {
+            auto& histogram = histograms[pass];
+            uint32_t firstByte = ((*source)[0].key >> (pass * 8)) & 0xFF;
+            if (histogram[firstByte] == count) continue;
+
+            uint32_t offsets[BUCKETS];
+            uint32_t sum = 0;
+            for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket) {
+                offsets[bucket] = sum;
+                sum += histogram[bucket];
+            }
+
+            for (const auto& item : *source) {
+                (*destination)[offsets[(item.key >> (pass * 8)) & 0xFF]++] = item;
+            }
+            std::swap(source, destination);
+        }
+
+        if (source != &ioItems) {
+            ioItems.swap(ioScratch);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include "saneengine/utils/timings.hpp"
+#include <mutex>
+#include <numeric>
+
+namespace sane::utils {
+    class Timings::Impl {
+    public:
+        mutable std::mutex mutex;
+        std::vector<std::shared_ptr<TimingTrack>> tracks;
+    };
+
+    Timings::Timings() : mImpl(new Impl) {}
+
+    Timings::~Timings() {
+        delete mImpl;
+    }
+
+    Timings& Timings::get() {
+        static Timings instance;
+        return instance;
+    }
+
+    std::shared_ptr<TimingTrack> Timings::addTrack(std::string name, TimingKind kind) {
+        if constexpr (!TIMINGS_ENABLED) {
+            return nullptr;
+        }
+
+        auto track = std::make_shared<TimingTrack>(std::move(name), kind);
+        std::lock_guard<std::mutex> lock(mImpl->mutex);
+        mImpl->tracks.push_back(track);
+        return track;
+    }
+
+    void Timings::removeTrack(const TimingTrack* track) {
+        std::lock_guard<std::mutex> lock(mImpl->mutex);
+        std::erase_if(mImpl->tracks, [track](const auto& candidate) {
+            return candidate.get() == track;
+        });
+    }
+
+    std::vector<TimingStats> Timings::query() const {
+        // Tracks stay alive through the copies even if their owner goes away meanwhile
+        std::vector<std::shared_ptr<TimingTrack>> tracks;
+        {
+            std::lock_guard<std::mutex> lock(mImpl->mutex);
+            tracks = mImpl->tracks;
+        }
+
+        std::vector<TimingStats> stats;
+        stats.reserve(tracks.size());
+        std::vector<float> sorted;
+        for (const auto& track : tracks) {
+            TimingStats entry{ track->getName(), track->getKind(), 0.0f, 0.0f, 0.0f, {} };
+            track->copySamples(entry.history);
+            if (entry.history.empty()) continue;
+
+            sorted.assign(entry.history.begin(), entry.history.end());
+            size_t p99Index = (sorted.size() * 99) / 100;
+            std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.end());
+            entry.p99 = sorted[p99Index];
+            entry.max = *std::max_element(entry.history.begin(), entry.history.end());
+            entry.average = std::accumulate(entry.history.begin(), entry.history.end(), 0.0f) / entry.history.size();
+            stats.push_back(std::move(entry));
+        }
+        return stats;
+    }
+}
@@ -1,53 +1,213 @@
 #include "saneengine/window.hpp"
 #include <glad/glad.h>  // Include GLAD header
 #include <GLFW/glfw3.h>
+#if SANEENGINE_HAS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#include <chrono>
 #include <stdexcept>
+#include <thread>
 
 namespace sane {
-    Window::Window(const char* title, uint32_t width, uint32_t height)
-        : mWidth(width), mHeight(height), mGLFWwindow(nullptr), mTitle(title)
+    Window::Window(const char* title, uint32_t width, uint32_t height, bool headless)
+        : mWidth(width), mHeight(height), mGLFWwindow(nullptr), mTitle(title), mHeadless(headless)
     {
         if (!glfwInit()) {
+            if (headless) {
+                createEglContext();
+                return;
+            }
             throw std::runtime_error("Failed to initialize GLFW");
         }
 
+        if (headless) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        }
         mGLFWwindow = glfwCreateWindow(width, height, title, nullptr, nullptr);
         if (!mGLFWwindow) {
             glfwTerminate();
+            if (headless) {
+                createEglContext();
+                return;
+            }
             throw std::runtime_error("Failed to create GLFW window");
         }
 
         glfwMakeContextCurrent(mGLFWwindow);
-        glfwSwapInterval(1);
+        // Headless frames are never presented, nothing should wait for vsync
+        if (headless) {
+            glfwSwapInterval(0);
+        }
+        else {
+            setPresentMode(gfx::PresentMode::VSync);
+        }
     }
 
     Window::~Window() {
         if (mGLFWwindow) {
             glfwDestroyWindow(mGLFWwindow);
         }
+#if SANEENGINE_HAS_EGL
+        if (mEglContext) {
+            eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(mEglDisplay, mEglContext);
+            eglTerminate(mEglDisplay);
+        }
+#endif
         glfwTerminate();
     }
 
+    void Window::createEglContext() {
+#if SANEENGINE_HAS_EGL
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        EGLDisplay display = getPlatformDisplay
+            ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+            : EGL_NO_DISPLAY;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+            throw std::runtime_error("Failed to open an EGL display for headless rendering");
+        }
+
+        // Surfaceless, so the context needs no config and draws only into framebuffer objects
+        const EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        EGLContext context = eglBindAPI(EGL_OPENGL_API)
+            ? eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes)
+            : EGL_NO_CONTEXT;
+        if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            if (context != EGL_NO_CONTEXT) {
+                eglDestroyContext(display, context);
+            }
+            eglTerminate(display);
+            throw std::runtime_error("Failed to create an EGL context for headless rendering");
+        }
+
+        mEglDisplay = display;
+        mEglContext = context;
+#else
+        throw std::runtime_error("Headless rendering without a display needs EGL");
+#endif
+    }
+
     void Window::initializeGlad() {
-        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        if (!gladLoadGLLoader(&Window::getProcAddress)) {
             throw std::runtime_error("Failed to initialize GLAD");
         }
+
+        // Bound once, the binding is context state and stays when the render thread takes the context over
+        if (mHeadless && !mFramebuffer) {
+            GLuint renderbuffers[2];
+            glGenRenderbuffers(2, renderbuffers);
+            glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, mWidth, mHeight);
+            glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, mWidth, mHeight);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+            glGenFramebuffers(1, &mFramebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                throw std::runtime_error("Failed to create the offscreen framebuffer");
+            }
+            glViewport(0, 0, mWidth, mHeight);
+        }
     }
 
     bool Window::shouldClose() const {
-        return glfwWindowShouldClose(mGLFWwindow);
+        return mCloseRequested || (mGLFWwindow && glfwWindowShouldClose(mGLFWwindow));
     }
 
     void Window::close() {
-        glfwSetWindowShouldClose(mGLFWwindow, GLFW_TRUE);
+        mCloseRequested = true;
+        if (mGLFWwindow) {
+            glfwSetWindowShouldClose(mGLFWwindow, GLFW_TRUE);
+        }
     }
 
     void Window::swapBuffers() {
+        if (mHeadless) {
+            // Nothing to present, only hand the frame to the driver
+            glFlush();
+            return;
+        }
         glfwSwapBuffers(mGLFWwindow);
     }
 
+    gfx::PresentMode Window::setPresentMode(gfx::PresentMode mode) {
+        if (mHeadless || !mGLFWwindow) return gfx::PresentMode::Immediate;
+
+        // A negative interval only means adaptive with swap_control_tear
+        if (mode == gfx::PresentMode::AdaptiveVSync
+            && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+            && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+            mode = gfx::PresentMode::VSync;
+        }
+
+        switch (mode) {
+        case gfx::PresentMode::Immediate: glfwSwapInterval(0); break;
+        case gfx::PresentMode::VSync: glfwSwapInterval(1); break;
+        case gfx::PresentMode::AdaptiveVSync: glfwSwapInterval(-1); break;
+        }
+        return mode;
+    }
+
+    void Window::pollEvents() {
+        if (mGLFWwindow) {
+            glfwPollEvents();
+            return;
+        }
+        // No window to get events for, just keep the main thread from spinning
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    void Window::makeContextCurrent() {
+#if SANEENGINE_HAS_EGL
+        if (mEglContext) {
+            if (!eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, mEglContext)) {
+                throw std::runtime_error("Failed to make the EGL context current");
+            }
+            return;
+        }
+#endif
+        glfwMakeContextCurrent(mGLFWwindow);
+    }
+
+    void Window::releaseContext() {
+#if SANEENGINE_HAS_EGL
+        if (mEglContext) {
+            eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            return;
+        }
+#endif
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    bool Window::isHeadless() const {
+        return mHeadless;
+    }
+
     GLFWwindow* Window::getNativeWindow() const {
         return mGLFWwindow;
     }
 
-} // namespace sane
\ No newline at end of file
+    void* Window::getProcAddress(const char* name) {
+#if SANEENGINE_HAS_EGL
+        if (eglGetCurrentContext() != EGL_NO_CONTEXT) {
+            return reinterpret_cast<void*>(eglGetProcAddress(name));
+        }
+#endif
+        return reinterpret_cast<void*>(glfwGetProcAddress(name));
+    }
+
+} // namespace sane